@@ -1,6 +1,27 @@
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 // ArraysAndStrings.cpp
 
@@ -8,7 +29,9 @@
 // Implement an algorithm to determine if a string has all unique characters. What if you cannot use additional data structures?
 
 // using hashset
-bool IsUnique1(const std::string& str) {
+// everything takes std::string_view so bytes from a file or a network buffer dont have to be copied into 
+// a std::string first (a std::string or a literal converts by itself). The set still allocates
+bool IsUnique1(std::string_view str) {
 
     if (str.length() == 0) { return true; }
 
@@ -22,45 +45,245 @@ bool IsUnique1(const std::string& str) {
     return true; 
 }
 // not using any data structures 
-// Do we need to handle a character being '\0'?
-bool IsUnique2(const std::string& str) {
+// Do we need to handle a character being '\0'? (yes, and anything >= 0x80, index with unsigned char 
+// so those dont go negative and the table needs all 256 entries)
+bool IsUnique2(std::string_view str) {
     if (str.length() == 0) { return true; }
 
-    char table[0xff]; 
+    bool table[0x100]; 
     memset(table, 0, sizeof(table));
 
     for (auto c : str) {
-        if (table[c]) {return false;} 
-        else {table[c] = c;}
+        if (table[(unsigned char) c]) {return false;} 
+        else {table[(unsigned char) c] = true;}
     }
 
     return true; 
 }
 
+// one bit for each of the 256 byte values instead of a table of bools, the whole thing is 4 words. 
+// repeats collects the bits that were already set and only gets checked every 16 bytes so there's 
+// no branch on every character
+bool IsUniqueBitmap(const char* str, size_t length) {
+    uint64_t seen[4] = {0, 0, 0, 0}; 
+    uint64_t repeats = 0; 
+
+    for (size_t i = 0; i < length; i++) {
+        auto c = (unsigned char) str[i]; 
+        auto bit = 1ull << (c & 63); 
+
+        repeats |= seen[c >> 6] & bit; 
+        seen[c >> 6] |= bit; 
+
+        if ((i & 15) == 15 && repeats) { return false; }
+    }
+
+    return repeats == 0; 
+}
+
+#ifdef __SSE2__
+// lane i gets x[(i + Shift) % 16]
+template<int Shift>
+inline __m128i RotateBytes(__m128i x) {
+#ifdef __SSSE3__
+    return _mm_alignr_epi8(x, x, Shift); 
+#else
+    return _mm_or_si128(_mm_srli_si128(x, Shift), _mm_slli_si128(x, (16 - Shift) & 15)); 
+#endif
+}
+
+// lanes of a full block that equal some other lane. Rotating by 1 to 8 is enough, rotating by 16 - r 
+// compares the same pairs as r
+template<int... Shifts>
+inline __m128i RepeatsInBlock(__m128i block, std::integer_sequence<int, Shifts...>) {
+    auto repeats = _mm_setzero_si128(); 
+    ((repeats = _mm_or_si128(repeats, _mm_cmpeq_epi8(block, RotateBytes<Shifts + 1>(block)))), ...); 
+    return repeats; 
+}
+
+// lanes of b that equal any lane of a, going round every rotation of a compares all of b with all of a
+template<int... Shifts>
+inline __m128i RepeatsBetweenBlocks(__m128i a, __m128i b, std::integer_sequence<int, Shifts...>) {
+    auto repeats = _mm_setzero_si128(); 
+    ((repeats = _mm_or_si128(repeats, _mm_cmpeq_epi8(b, RotateBytes<Shifts>(a)))), ...); 
+    return repeats; 
+}
+
+// 16 to 32 bytes: compare each 16 byte block with its own rotations and b with every rotation of a, 
+// every pair of positions gets compared and there's no loop over the characters or a branch per 
+// character at all. 
+// Both loads stay inside the string, the second one is the last 16 bytes so when length < 32 its 
+// first 32 - length lanes are the same bytes as the end of a. Those lanes are masked out of the 
+// a against b compare (they'd match themselves), a's own compare already covers them
+inline bool IsUniqueShort(const char* str, size_t length) {
+    auto inBlock = std::make_integer_sequence<int, 8>(); 
+    auto a = _mm_loadu_si128((const __m128i*) str); 
+
+    if (length == 16) { return _mm_movemask_epi8(RepeatsInBlock(a, inBlock)) == 0; }
+
+    auto index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); 
+    auto b = _mm_loadu_si128((const __m128i*) (str + length - 16)); 
+    auto validB = _mm_cmpgt_epi8(index, _mm_set1_epi8((char) (31 - length))); // lane >= 32 - length
+
+    auto repeats = _mm_or_si128(RepeatsInBlock(a, inBlock), RepeatsInBlock(b, inBlock)); 
+    repeats = _mm_or_si128(repeats, _mm_and_si128(RepeatsBetweenBlocks(a, b, std::make_integer_sequence<int, 16>()), validB)); 
+
+    return _mm_movemask_epi8(repeats) == 0; 
+}
+#endif
+
+// 1.1 with a 256 bit mask
+// anything longer than 256 bytes has to repeat something (pigeonhole) so that's O(1), 
+// 16 to 32 bytes go through SSE2 when there is any. Under 16 there isnt a whole block to load 
+// and IsUnique2's bool table is quicker than the bitmap (memset and a store per byte, no shifts)
+bool IsUnique3(const char* str, size_t length) {
+    if (length > 256) { return false; }
+    if (length < 16) { return IsUnique2(std::string_view(str, length)); }
+
+#ifdef __SSE2__
+    if (length <= 32) { return IsUniqueShort(str, length); }
+#endif
+
+    return IsUniqueBitmap(str, length); 
+}
+
+bool IsUnique3(std::string_view str) {
+    return IsUnique3(str.data(), str.length()); 
+}
+
+// lots of strings at once, results[i] is 1 if strs[i] is unique. Returns how many were
+size_t IsUnique3(const std::vector<std::string>& strs, std::vector<uint8_t>& results) {
+    size_t uniqueCount = 0; 
+    results.resize(strs.size()); 
+
+    for (size_t i = 0; i < strs.size(); i++) {
+        results[i] = IsUnique3(strs[i].data(), strs[i].length()); 
+        uniqueCount += results[i]; 
+    }
+
+    return uniqueCount; 
+}
+
 // 1.2 
 // Given two strings, write an algorithm to decide if one is a permuation of the other
 // if the strings have the same characters and the same frequency of each character then they are permutations
-bool CheckPermutation(const std::string& a, const std::string& b) {
+bool CheckPermutation(std::string_view a, std::string_view b) {
 
     if (a.length() != b.length()) { return false; }
 
     // O(n) solution
     // memory O(1)
 
-    // NOTE: need to use larger int type if the string is really big
-    // NOTE: only works with ASCII characters, I'd assume
-    char tableA[0xff]; memset(tableA, 0, sizeof(tableA)); 
-    char tableB[0xff]; memset(tableB, 0, sizeof(tableB));
+    // NOTE: need to use larger int type if the string is really big (CheckPermutation2 does)
+    // NOTE: index with unsigned char so it works with any byte not just ASCII
+    char tableA[0x100]; memset(tableA, 0, sizeof(tableA)); 
+    char tableB[0x100]; memset(tableB, 0, sizeof(tableB));
 
     for (auto c : a) {
-        tableA[c]++; 
+        tableA[(unsigned char) c]++; 
     }
 
     for(auto c : b) {
-        tableB[c]++;
+        tableB[(unsigned char) c]++;
+    }
+
+    return memcmp(tableA, tableB, 0x100) == 0; 
+}
+
+// counts for one chunk split over Tables sub-histograms, half of them for a and half for b, so a run 
+// of the same byte doesnt keep incrementing the same counter (each increment would have to wait for 
+// the last one's store). With Tables = 1 everything goes into one histogram. 
+// 32 bit counters are plenty for one chunk, they get added into 64 bit totals after
+const size_t HistogramChunk = 1 << 30; 
+
+template<int Tables>
+void AddHistogramChunk(const unsigned char* a, const unsigned char* b, size_t length, int64_t* totals) {
+    const int step = Tables > 1 ? Tables / 2 : 1; 
+
+    uint32_t counts[Tables][0x100]; 
+    memset(counts, 0, sizeof(counts)); 
+
+    size_t i = 0; 
+    for (; i + step <= length; i += step) {
+        for (int w = 0; w < step; w++) { counts[w][a[i + w]]++; }
+        for (int w = 0; w < step; w++) { counts[Tables - step + w][b[i + w]]--; }
+    }
+
+    for (; i < length; i++) {
+        counts[0][a[i]]++; 
+        counts[Tables - 1][b[i]]--; 
+    }
+
+    // wrapped round if there were more decrements but it's still right as an int32_t
+    for (int w = 0; w < Tables; w++) {
+        for (int c = 0; c < 0x100; c++) { totals[c] += (int32_t) counts[w][c]; }
+    }
+}
+
+// a and b add up to the same histogram when totals are all 0
+bool AllZero(const int64_t* totals) {
+#ifdef __SSE2__
+    auto any = _mm_setzero_si128(); 
+    for (int c = 0; c < 0x100; c += 2) {
+        any = _mm_or_si128(any, _mm_loadu_si128((const __m128i*) (totals + c))); 
     }
 
-    return memcmp(tableA, tableB, 0xff) == 0; 
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xffff; 
+#else
+    int64_t any = 0; 
+    for (int c = 0; c < 0x100; c++) { any |= totals[c]; }
+    return any == 0; 
+#endif
+}
+
+// 1.2 for big strings
+// one histogram, +1 for every byte of a and -1 for every byte of b, it's all zeros if they're permutations. 
+// Counters are 64 bit in the end so any length works, and any byte value
+template<int Tables = 4>
+bool CheckPermutation2(const char* a, size_t lengthA, const char* b, size_t lengthB) {
+    if (lengthA != lengthB) { return false; }
+
+    int64_t totals[0x100] = {}; 
+
+    for (size_t begin = 0; begin < lengthA; begin += HistogramChunk) {
+        auto length = std::min(HistogramChunk, lengthA - begin); 
+        AddHistogramChunk<Tables>((const unsigned char*) a + begin, (const unsigned char*) b + begin, length, totals); 
+    }
+
+    return AllZero(totals); 
+}
+
+bool CheckPermutation2(std::string_view a, std::string_view b) {
+    return CheckPermutation2(a.data(), a.length(), b.data(), b.length()); 
+}
+
+// same thing split into threadCount pieces each with their own histogram, added up at the end
+bool CheckPermutationParallel(const char* a, size_t lengthA, const char* b, size_t lengthB, unsigned int threadCount) {
+    if (lengthA != lengthB) { return false; }
+    if (threadCount <= 1) { return CheckPermutation2(a, lengthA, b, lengthB); }
+
+    std::vector<std::vector<int64_t>> totals(threadCount, std::vector<int64_t>(0x100, 0)); 
+    std::vector<std::thread> threads; 
+
+    for (unsigned int t = 0; t < threadCount; t++) {
+        auto begin = lengthA * t / threadCount; 
+        auto end = lengthA * (t + 1) / threadCount; 
+
+        threads.push_back(std::thread([=, &totals] {
+            for (auto chunk = begin; chunk < end; chunk += HistogramChunk) {
+                auto length = std::min(HistogramChunk, end - chunk); 
+                AddHistogramChunk<4>((const unsigned char*) a + chunk, (const unsigned char*) b + chunk, length, totals[t].data()); 
+            }
+        })); 
+    }
+
+    for (auto& thread : threads) { thread.join(); }
+
+    for (unsigned int t = 1; t < threadCount; t++) {
+        for (int c = 0; c < 0x100; c++) { totals[0][c] += totals[t][c]; }
+    }
+
+    return AllZero(totals[0].data()); 
 }
 
 // 1.3
@@ -75,35 +298,174 @@ void URLify(std::string& str) {
     const std::string spaceCode = "%20"; 
     auto codeLen = spaceCode.length(); 
 
+    // replace the space, inserting in front of it left it there. Still shifts the rest of the string 
+    // for every space, URLify2 doesnt
     for (auto i = 0; i < str.length(); i++) {
         if (str[i] == ' ') {
-            str.insert(i, spaceCode); 
-            i += codeLen; 
+            str.replace(i, 1, spaceCode); 
+            i += codeLen - 1; 
         }
     }
 }
 
+// how many spaces, 16 at a time with SSE2
+size_t CountSpaces(const char* str, size_t length) {
+    size_t count = 0; 
+    size_t i = 0; 
+
+#ifdef __SSE2__
+    auto spaces = _mm_set1_epi8(' '); 
+    for (; i + 16 <= length; i += 16) {
+        auto block = _mm_loadu_si128((const __m128i*) (str + i)); 
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, spaces))); 
+    }
+#endif
+
+    for (; i < length; i++) { count += str[i] == ' '; }
+
+    return count; 
+}
+
+// 1.3 the way the question means it
+// str has room for the extra characters after trueLength, fill it in from the back so every 
+// character only moves once. Returns the new length
+// the characters between two spaces get moved with one memmove
+size_t URLify(char* str, size_t trueLength, size_t spaceCount) {
+    auto end = trueLength; 
+    auto out = trueLength + 2 * spaceCount; 
+    auto newLength = out; 
+
+    // once out catches up with end there's no spaces left in front so nothing else moves
+    while (out != end) {
+        auto begin = end; 
+        while (begin > 0 && str[begin - 1] != ' ') { begin--; }
+
+        out -= end - begin; 
+        memmove(str + out, str + begin, end - begin); 
+
+        if (begin == 0) { break; }
+
+        out -= 3; 
+        memcpy(str + out, "%20", 3); 
+        end = begin - 1; 
+    }
+
+    return newLength; 
+}
+
+size_t URLify(char* str, size_t trueLength) {
+    return URLify(str, trueLength, CountSpaces(str, trueLength)); 
+}
+
+// std::string version, count the spaces, resize once and fill from the back. O(n)
+void URLify2(std::string& str) {
+    auto spaceCount = CountSpaces(str.data(), str.length()); 
+    if (spaceCount == 0) { return; }
+
+    auto trueLength = str.length(); 
+    str.resize(trueLength + 2 * spaceCount); 
+    URLify(&str[0], trueLength, spaceCount); 
+}
+
+// for a view that cant be written to, copy into out going forwards. Like PercentEncode returns the 
+// length it needs and doesnt write anything if that's more than capacity
+size_t URLify(std::string_view str, char* out, size_t capacity) {
+    auto newLength = str.length() + 2 * CountSpaces(str.data(), str.length()); 
+    if (newLength > capacity) { return newLength; }
+
+    for (auto c : str) {
+        if (c == ' ') {
+            memcpy(out, "%20", 3); 
+            out += 3; 
+        } else {
+            *out++ = c; 
+        }
+    }
+
+    return newLength; 
+}
+
+// RFC 3986 unreserved characters, the ones that never need encoding: A-Z a-z 0-9 - . _ ~
+struct UnreservedTable {
+    bool keep[0x100]; 
+
+    explicit UnreservedTable(const char* alsoKeep = "") {
+        for (int c = 0; c < 0x100; c++) {
+            keep[c] = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~'; 
+        }
+
+        for (auto c = alsoKeep; *c; c++) { keep[(unsigned char) *c] = true; }
+    }
+}; 
+
+const UnreservedTable unreserved; 
+
+// length after percent encoding, every byte that's not kept becomes 3
+size_t PercentEncodedLength(const char* str, size_t length, const UnreservedTable& table = unreserved) {
+    auto encodedLength = length; 
+    for (size_t i = 0; i < length; i++) { encodedLength += table.keep[(unsigned char) str[i]] ? 0 : 2; }
+    return encodedLength; 
+}
+
+// percent encode str into out without allocating anything. Returns the encoded length, if that's 
+// more than capacity nothing is written (call again with a bigger buffer) 
+size_t PercentEncode(const char* str, size_t length, char* out, size_t capacity, const UnreservedTable& table = unreserved) {
+    const char* hex = "0123456789ABCDEF"; 
+
+    auto encodedLength = PercentEncodedLength(str, length, table); 
+    if (encodedLength > capacity) { return encodedLength; }
+
+    for (size_t i = 0; i < length; i++) {
+        auto c = (unsigned char) str[i]; 
+
+        if (table.keep[c]) {
+            *out++ = (char) c; 
+        } else {
+            out[0] = '%'; 
+            out[1] = hex[c >> 4]; 
+            out[2] = hex[c & 15]; 
+            out += 3; 
+        }
+    }
+
+    return encodedLength; 
+}
+
+size_t PercentEncode(std::string_view str, char* out, size_t capacity, const UnreservedTable& table = unreserved) {
+    return PercentEncode(str.data(), str.length(), out, capacity, table); 
+}
+
+// one allocation for the result. pass UnreservedTable("/") to leave the slashes in a path alone
+std::string PercentEncode(std::string_view str, const UnreservedTable& table = unreserved) {
+    std::string encoded(PercentEncodedLength(str.data(), str.length(), table), '\0'); 
+    PercentEncode(str.data(), str.length(), &encoded[0], encoded.length(), table); 
+    return encoded; 
+}
+
 // 1.4
 // Given a string, write a function to check if it is a permutation of a palindrome. 
-bool IsPermutationOfPalindrome(const std::string& str) {
-    // lets say that a string of length 1 or 0 is not a palindrome
-    if (str.length() < 2) { return false; }
-
+bool IsPermutationOfPalindrome(std::string_view str) {
     // if the string has an odd number of characters there must be an even frequency of each character except for one character
     // if the string length is even then there must be an even number of all characters
 
     // this is O(n) solution 
     // memory O(1)
 
-    // NOTE: need bigger int for really big strings
-    char table[0xff]; memset(table, 0, sizeof(table)); 
+    // NOTE: need bigger int for really big strings (IsPermutationOfPalindrome2 only keeps odd/even)
+    // NOTE: index with unsigned char, and the spaces dont count towards the length
+    char table[0x100]; memset(table, 0, sizeof(table)); 
+    size_t length = 0; 
 
     for (auto c : str) {
         if (c == ' ') {continue;}
-        table[c]++;
+        table[(unsigned char) c]++;
+        length++; 
     }
 
-    if (str.length() % 2) {
+    // lets say that a string of length 1 or 0 is not a palindrome
+    if (length < 2) { return false; }
+
+    if (length % 2) {
         unsigned int oddFreq = 0; 
         for (auto c : table) {
             if (c % 2) { oddFreq++; }
@@ -118,6 +480,784 @@ bool IsPermutationOfPalindrome(const std::string& str) {
     return true; 
 }
 
+// 1.4 with a parity mask
+// only odd or even matters so flip one bit per character in a 256 bit mask, at the end the set bits 
+// are the characters that showed up an odd number of times and a palindrome can have at most one. 
+// (that works out whether the length is odd or even, an even length can't have exactly one odd count) 
+// Flipping the same 64 bit word for every character makes each flip wait for the last one so 
+// there's 4 masks taking turns, they get xor'd together at the end. Long strings count instead (see OddCountsLong). 
+// Same rules as IsPermutationOfPalindrome: spaces dont count and less than 2 characters is false
+const size_t PalindromeCountingLength = 4096; 
+
+// for long strings bumping a count is cheaper than the shift and xor, and since only odd/even matters 
+// 8 bit counts that wrap round are fine. 4 tables so repeats dont queue up on the same counter, 
+// then the low bits of the 4 get xor'd together into the same 256 bit mask as the short version
+void OddCountsLong(const unsigned char* bytes, size_t length, uint64_t parity[4]) {
+    alignas(16) uint8_t counts[4][0x100]; 
+    memset(counts, 0, sizeof(counts)); 
+
+    size_t i = 0; 
+    for (; i + 4 <= length; i += 4) {
+        counts[0][bytes[i]]++; 
+        counts[1][bytes[i + 1]]++; 
+        counts[2][bytes[i + 2]]++; 
+        counts[3][bytes[i + 3]]++; 
+    }
+
+    for (; i < length; i++) { counts[0][bytes[i]]++; }
+
+#ifdef __SSE2__
+    for (int block = 0; block < 16; block++) {
+        auto sum = _mm_xor_si128(
+            _mm_xor_si128(_mm_load_si128((const __m128i*) (counts[0] + block * 16)), _mm_load_si128((const __m128i*) (counts[1] + block * 16))), 
+            _mm_xor_si128(_mm_load_si128((const __m128i*) (counts[2] + block * 16)), _mm_load_si128((const __m128i*) (counts[3] + block * 16)))); 
+
+        // low bit of each byte up to the sign bit for movemask
+        uint64_t bits = (uint16_t) _mm_movemask_epi8(_mm_slli_epi16(sum, 7)); 
+        parity[block / 4] |= bits << (block % 4 * 16); 
+    }
+#else
+    for (int c = 0; c < 0x100; c++) {
+        uint64_t bit = (counts[0][c] ^ counts[1][c] ^ counts[2][c] ^ counts[3][c]) & 1; 
+        parity[c >> 6] |= bit << (c & 63); 
+    }
+#endif
+}
+
+bool IsPermutationOfPalindrome2(const char* str, size_t length) {
+    auto bytes = (const unsigned char*) str; 
+
+    if (length >= PalindromeCountingLength) {
+        uint64_t odd[4] = {0, 0, 0, 0}; 
+        OddCountsLong(bytes, length, odd); 
+        odd[0] &= ~(1ull << ' '); 
+
+        // cant have less than 2 characters in here unless it's nearly all spaces
+        if (length - CountSpaces(str, length) < 2) { return false; }
+        return __builtin_popcountll(odd[0]) + __builtin_popcountll(odd[1]) + __builtin_popcountll(odd[2]) + __builtin_popcountll(odd[3]) <= 1; 
+    }
+
+    uint64_t parity[4][4] = {}; 
+
+    size_t i = 0; 
+    for (; i + 4 <= length; i += 4) {
+        for (int w = 0; w < 4; w++) {
+            parity[w][bytes[i + w] >> 6] ^= 1ull << (bytes[i + w] & 63); 
+        }
+    }
+
+    for (; i < length; i++) {
+        parity[0][bytes[i] >> 6] ^= 1ull << (bytes[i] & 63); 
+    }
+
+    if (length - CountSpaces(str, length) < 2) { return false; }
+
+    unsigned int oddCount = 0; 
+    for (int word = 0; word < 4; word++) {
+        auto bits = parity[0][word] ^ parity[1][word] ^ parity[2][word] ^ parity[3][word]; 
+        if (word == 0) { bits &= ~(1ull << ' '); }
+        oddCount += __builtin_popcountll(bits); 
+    }
+
+    return oddCount <= 1; 
+}
+
+bool IsPermutationOfPalindrome2(std::string_view str) {
+    return IsPermutationOfPalindrome2(str.data(), str.length()); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// CodePointParity
+// odd/even for code points above ASCII, open addressing with linear probing in a power of 2 table. 
+// Entries are never removed, the top bit of each one is the parity and the rest is the code point 
+// (0 is empty, code point 0 is ASCII so it never comes in here) 
+//------------------------------------------------------------------------------------------------------
+struct CodePointParity {
+    std::vector<uint32_t> slots; 
+    size_t used = 0; 
+
+    // nothing gets allocated until the first character above ASCII
+    void Flip(uint32_t codePoint) {
+        if ((used + 1) * 2 > slots.size()) { Grow(); }
+
+        auto mask = slots.size() - 1; 
+        for (auto i = (codePoint * 2654435761u) & mask; ; i = (i + 1) & mask) {
+            if (slots[i] == 0) {
+                slots[i] = codePoint | 0x80000000u; 
+                used++; 
+                return; 
+            }
+
+            if ((slots[i] & 0x7fffffffu) == codePoint) {
+                slots[i] ^= 0x80000000u; 
+                return; 
+            }
+        }
+    }
+
+    void Grow() {
+        std::vector<uint32_t> old(slots.empty() ? 64 : slots.size() * 2, 0); 
+        old.swap(slots); 
+
+        auto mask = slots.size() - 1; 
+        for (auto entry : old) {
+            if (entry == 0) { continue; }
+
+            auto i = ((entry & 0x7fffffffu) * 2654435761u) & mask; 
+            while (slots[i] != 0) { i = (i + 1) & mask; }
+            slots[i] = entry; 
+        }
+    }
+
+    size_t OddCount() const {
+        size_t count = 0; 
+        for (auto entry : slots) { count += entry >> 31; }
+        return count; 
+    }
+}; 
+
+// next code point from str[i..length), moves i past it. A byte that doesnt start a valid UTF-8 
+// sequence comes back as 0x110000 + the byte (past the last real code point) so it still counts as something
+uint32_t NextCodePoint(const unsigned char* str, size_t length, size_t& i) {
+    auto lead = str[i]; 
+    if (lead < 0x80) { i++; return lead; }
+
+    int extra = lead >= 0xf5 ? 0 : lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : lead >= 0xc2 ? 1 : 0; 
+    if (extra == 0 || i + extra >= length) { i++; return 0x110000 + lead; }
+
+    uint32_t codePoint = lead & (0x3f >> extra); 
+
+    for (int k = 1; k <= extra; k++) {
+        if ((str[i + k] & 0xc0) != 0x80) { i++; return 0x110000 + lead; }
+        codePoint = (codePoint << 6) | (str[i + k] & 0x3f); 
+    }
+
+    i += extra + 1; 
+    return codePoint; 
+}
+
+// IsPermutationOfPalindrome2 counting UTF-8 code points instead of bytes, "été" is 3 characters. 
+// ASCII goes in a 128 bit mask and everything else in a CodePointParity (so this is the one that 
+// can allocate, only when there's something above ASCII)
+bool IsPermutationOfPalindromeUtf8(const char* str, size_t length) {
+    auto bytes = (const unsigned char*) str; 
+    uint64_t parity[2] = {0, 0}; 
+    CodePointParity others; 
+    size_t characters = 0; 
+
+    for (size_t i = 0; i < length; ) {
+        if (bytes[i] < 0x80) {
+            parity[bytes[i] >> 6] ^= 1ull << (bytes[i] & 63); 
+            characters += bytes[i] != ' '; 
+            i++; 
+        } else {
+            others.Flip(NextCodePoint(bytes, length, i)); 
+            characters++; 
+        }
+    }
+
+    if (characters < 2) { return false; }
+
+    auto oddCount = __builtin_popcountll(parity[0] & ~(1ull << ' ')) + __builtin_popcountll(parity[1]) + others.OddCount(); 
+    return oddCount <= 1; 
+}
+
+bool IsPermutationOfPalindromeUtf8(std::string_view str) {
+    return IsPermutationOfPalindromeUtf8(str.data(), str.length()); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// StringColumn
+// lots of strings packed end to end in one buffer like an Arrow string column, record i is 
+// data[offsets[i], offsets[i + 1]) so there's count + 1 offsets. Doesnt own anything, 
+// OwnedStringColumn does. Offsets are 32 bit like Arrow's string (not large_string) so a column 
+// holds at most ColumnMaxBytes of data, anything that would go past that fails instead of wrapping
+//------------------------------------------------------------------------------------------------------
+const size_t ColumnMaxBytes = 0x7fffffff; // largest int32_t offset
+
+struct StringColumn {
+    const char* data; 
+    const int32_t* offsets; 
+    size_t count; 
+
+    const char* Record(size_t i) const { return data + offsets[i]; }
+    size_t Length(size_t i) const { return offsets[i + 1] - offsets[i]; }
+    std::string_view operator[](size_t i) const { return std::string_view(Record(i), Length(i)); }
+}; 
+
+struct OwnedStringColumn {
+    std::vector<char> data; 
+    std::vector<int32_t> offsets{0}; 
+
+    // false (and nothing appended) if the column would go past ColumnMaxBytes
+    bool Append(const char* str, size_t length) {
+        if (length > ColumnMaxBytes - data.size()) { return false; }
+
+        data.insert(data.end(), str, str + length); 
+        offsets.push_back((int32_t) data.size()); 
+        return true; 
+    }
+
+    StringColumn View() const { return StringColumn{data.data(), offsets.data(), offsets.size() - 1}; }
+}; 
+
+// stops at the first string that doesnt fit, so the column is short if strs add up to more than ColumnMaxBytes
+OwnedStringColumn ToStringColumn(const std::vector<std::string>& strs) {
+    OwnedStringColumn column; 
+    column.offsets.reserve(strs.size() + 1); 
+    for (auto& str : strs) { 
+        if (!column.Append(str.data(), str.length())) { break; }
+    }
+
+    return column; 
+}
+
+// threads get runs of 64 records so every one of them writes whole words of the bitmap, 
+// and there's no point starting a thread for less than this many records
+const size_t BatchRecordsPerThread = 1 << 14; 
+
+unsigned int BatchThreadCount(size_t count, unsigned int threadCount) {
+    if (threadCount == 0) { threadCount = std::max(1u, std::thread::hardware_concurrency()); }
+    return (unsigned int) std::max<size_t>(1, std::min<size_t>(threadCount, count / BatchRecordsPerThread)); 
+}
+
+// runs f(firstWord, lastWord) over the 64 record words of count records split between the threads
+template<typename F>
+void ForEachWordRange(size_t count, unsigned int threadCount, F f) {
+    auto wordCount = (count + 63) / 64; 
+    threadCount = BatchThreadCount(count, threadCount); 
+
+    if (threadCount == 1) { f(0, wordCount); return; }
+
+    std::vector<std::thread> threads; 
+    for (unsigned int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread(f, wordCount * t / threadCount, wordCount * (t + 1) / threadCount)); 
+    }
+
+    for (auto& thread : threads) { thread.join(); }
+}
+
+// bit i of bitmap (bit i % 64 of word i / 64, Arrow's order) gets predicate(i), returns how many were set
+template<typename Predicate>
+size_t BatchBitmap(size_t count, unsigned int threadCount, std::vector<uint64_t>& bitmap, Predicate predicate) {
+    bitmap.assign((count + 63) / 64, 0); 
+    std::vector<size_t> setCounts((count + 63) / 64, 0); 
+
+    ForEachWordRange(count, threadCount, [&] (size_t firstWord, size_t lastWord) {
+        for (auto word = firstWord; word < lastWord; word++) {
+            uint64_t bits = 0; 
+            auto end = std::min(count, word * 64 + 64); 
+
+            for (auto i = word * 64; i < end; i++) { bits |= (uint64_t) predicate(i) << (i % 64); }
+
+            bitmap[word] = bits; 
+            setCounts[word] = __builtin_popcountll(bits); 
+        }
+    }); 
+
+    size_t setCount = 0; 
+    for (auto c : setCounts) { setCount += c; }
+    return setCount; 
+}
+
+bool BitmapGet(const std::vector<uint64_t>& bitmap, size_t i) {
+    return (bitmap[i / 64] >> (i % 64)) & 1; 
+}
+
+// 1.1 for every record in the column 
+size_t IsUniqueBatch(const StringColumn& column, std::vector<uint64_t>& bitmap, unsigned int threadCount = 0) {
+    return BatchBitmap(column.count, threadCount, bitmap, [&] (size_t i) { return IsUnique3(column.Record(i), column.Length(i)); }); 
+}
+
+// CheckPermutation2 clears 6 KB of tables every call which is most of the work for short records. 
+// Shorter than 256 one byte count per value is enough, +1 for a and -1 for b can only 
+// wrap round to 0 if they really are equal
+bool CheckPermutationShort(const char* a, const char* b, size_t length) {
+    alignas(16) uint8_t counts[0x100]; 
+    memset(counts, 0, sizeof(counts)); 
+
+    for (size_t i = 0; i < length; i++) {
+        counts[(unsigned char) a[i]]++; 
+        counts[(unsigned char) b[i]]--; 
+    }
+
+#ifdef __SSE2__
+    auto any = _mm_setzero_si128(); 
+    for (int i = 0; i < 0x100; i += 16) { any = _mm_or_si128(any, _mm_load_si128((const __m128i*) (counts + i))); }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xffff; 
+#else
+    for (auto c : counts) { if (c) { return false; } }
+    return true; 
+#endif
+}
+
+// 1.2 record i of a against record i of b. The columns have to be the same length, if they arent 
+// there's no answer for the extra records so it returns 0 with an empty bitmap rather than quietly 
+// checking the shorter one
+size_t CheckPermutationBatch(const StringColumn& a, const StringColumn& b, std::vector<uint64_t>& bitmap, unsigned int threadCount = 0) {
+    if (a.count != b.count) { bitmap.clear(); return 0; }
+
+    return BatchBitmap(a.count, threadCount, bitmap, [&] (size_t i) {
+        auto length = a.Length(i); 
+        if (length != b.Length(i)) { return false; }
+        if (length < 0x100) { return CheckPermutationShort(a.Record(i), b.Record(i), length); }
+        return CheckPermutation2(a.Record(i), length, b.Record(i), length); 
+    }); 
+}
+
+// 1.4, counting UTF-8 code points when utf8 is set
+size_t IsPermutationOfPalindromeBatch(const StringColumn& column, std::vector<uint64_t>& bitmap, bool utf8 = false, unsigned int threadCount = 0) {
+    if (utf8) {
+        return BatchBitmap(column.count, threadCount, bitmap, [&] (size_t i) { return IsPermutationOfPalindromeUtf8(column.Record(i), column.Length(i)); }); 
+    }
+
+    return BatchBitmap(column.count, threadCount, bitmap, [&] (size_t i) { return IsPermutationOfPalindrome2(column.Record(i), column.Length(i)); }); 
+}
+
+// 1.3 for every record, the output is another column. First pass counts the spaces so every 
+// record's new offset is known, then each thread writes its own records straight into place 
+// (it's not in place so it can go forwards). Reusing out between calls saves allocating and 
+// faulting in a new buffer every time. 
+// Every space grows by 2 bytes so the output can be too big for 32 bit offsets even when the input 
+// isnt, then it returns false and out is left empty
+bool URLifyBatch(const StringColumn& column, OwnedStringColumn& out, unsigned int threadCount = 0) {
+    out.offsets.resize(column.count + 1); 
+    out.offsets[0] = 0; 
+
+    ForEachWordRange(column.count, threadCount, [&] (size_t firstWord, size_t lastWord) {
+        auto end = std::min(column.count, lastWord * 64); 
+        for (auto i = firstWord * 64; i < end; i++) { out.offsets[i + 1] = (int32_t) CountSpaces(column.Record(i), column.Length(i)); }
+    }); 
+
+    // the spaces fit in an int32_t since the record does, the new lengths and their running total might not
+    uint64_t total = 0; 
+    for (size_t i = 0; i < column.count; i++) { 
+        total += 2 * (uint64_t) out.offsets[i + 1] + column.Length(i); 
+        if (total > ColumnMaxBytes) { 
+            out.data.clear(); 
+            out.offsets.assign(1, 0); 
+            return false; 
+        }
+
+        out.offsets[i + 1] = (int32_t) total; 
+    }
+
+    out.data.resize(out.offsets[column.count]); 
+
+    ForEachWordRange(column.count, threadCount, [&] (size_t firstWord, size_t lastWord) {
+        auto end = std::min(column.count, lastWord * 64); 
+        for (auto i = firstWord * 64; i < end; i++) {
+            auto str = column.Record(i); 
+            auto length = column.Length(i); 
+            auto dst = out.data.data() + out.offsets[i]; 
+
+            // records are short so a byte at a time beats looking for the spaces with memchr
+            for (size_t k = 0; k < length; k++) {
+                if (str[k] == ' ') {
+                    memcpy(dst, "%20", 3); 
+                    dst += 3; 
+                } else {
+                    *dst++ = str[k]; 
+                }
+            }
+        }
+    }); 
+
+    return true; 
+}
+
+// empty column if the output doesnt fit in 32 bit offsets
+OwnedStringColumn URLifyBatch(const StringColumn& column, unsigned int threadCount = 0) {
+    OwnedStringColumn out; 
+    URLifyBatch(column, out, threadCount); 
+    return out; 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------------------------------
+
+// time f() in milliseconds
+template<typename F> 
+double TimeMs(F f) {
+    auto start = std::chrono::high_resolution_clock::now(); 
+    f(); 
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: operator new / operator delete
+// Desc: replaces the global new and delete for the WHOLE program, not just the benchmarks, so every 
+// allocation anywhere (std::string, std::vector, the standard library itself) goes through malloc. 
+// Allocations are only counted inside CountAllocations, everywhere else it's one load and a branch 
+// on top of malloc so the other benchmarks (and the timed runs in BenchmarkStringViews) arent 
+// paying for an atomic add on every allocation. 
+// They're not inlined or gcc sees malloc and free where it expects new and delete and warns about it
+//------------------------------------------------------------------------------------------------------
+std::atomic<bool> countingAllocations{false}; 
+std::atomic<size_t> allocationCount{0}; 
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    if (countingAllocations.load(std::memory_order_relaxed)) { allocationCount.fetch_add(1, std::memory_order_relaxed); }
+    if (auto p = malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc(); 
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+
+// how many times f() calls new, run it separately from the timed run
+template<typename F>
+size_t CountAllocations(F f) {
+    allocationCount = 0; 
+    countingAllocations = true; 
+    f(); 
+    countingAllocations = false; 
+    return allocationCount; 
+}
+
+// count random strings with lengths in [minLength, maxLength] made of the first alphabetSize byte values 
+// starting from first
+std::vector<std::string> GenerateStrings(size_t count, size_t minLength, size_t maxLength, unsigned int alphabetSize, unsigned char first = 'a', uint32_t seed = 1234) {
+    std::mt19937 rng(seed); 
+    std::uniform_int_distribution<size_t> length(minLength, maxLength); 
+    std::vector<std::string> strs(count); 
+
+    for (auto& str : strs) {
+        str.resize(length(rng)); 
+        for (auto& c : str) { c = (char) (first + rng() % alphabetSize); }
+    }
+
+    return strs; 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkIsUnique
+// Desc: IsUnique1, IsUnique2, the bitmap on its own and IsUnique3 over lots of short tokens 
+// (most of them unique), then over long strings of all 256 byte values where the pigeonhole 
+// check does all the work
+//------------------------------------------------------------------------------------------------------
+void BenchmarkIsUnique(size_t count) {
+    auto run = [] (const char* label, const std::vector<std::string>& strs) {
+        size_t bytes = 0; 
+        for (auto& str : strs) { bytes += str.length(); }
+
+        size_t counts[4] = {0, 0, 0, 0}; 
+        double times[4]; 
+        std::vector<uint8_t> results; 
+
+        times[0] = TimeMs([&] { for (auto& str : strs) { counts[0] += IsUnique1(str); } }); 
+        times[1] = TimeMs([&] { for (auto& str : strs) { counts[1] += IsUnique2(str); } }); 
+        times[2] = TimeMs([&] { for (auto& str : strs) { counts[2] += IsUniqueBitmap(str.data(), str.length()); } }); 
+        times[3] = TimeMs([&] { counts[3] = IsUnique3(strs, results); }); 
+
+        const char* names[4] = {"IsUnique1 (unordered_set)", "IsUnique2 (bool table)   ", "bitmap                   ", "IsUnique3 batch          "}; 
+
+        std::cout << "IsUnique, " << strs.size() << " " << label << " (" << bytes / (1024 * 1024) << " MB)\n"; 
+        for (int i = 0; i < 4; i++) {
+            std::cout << "  " << names[i] << ": " << times[i] << " ms, " << strs.size() / (times[i] / 1000.0) / 1e6 << " M strings/s, " 
+                << counts[i] << " unique" << (counts[i] == counts[0] ? "" : " Error!") << "\n"; 
+        }
+    }; 
+
+    run("tokens of 1-16 letters", GenerateStrings(count, 1, 16, 26)); 
+    run("tokens of 8-32 bytes", GenerateStrings(count, 8, 32, 256, 0)); 
+    run("strings of 1000 bytes", GenerateStrings(count / 100, 1000, 1000, 256, 0)); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkCheckPermutation
+// Desc: a big random string against a shuffled copy, and against a copy with one byte changed, then 
+// the same with a string that's mostly one byte (where one histogram keeps hitting the same counter). 
+// GB/s counts both strings
+//------------------------------------------------------------------------------------------------------
+void BenchmarkCheckPermutation(size_t length, unsigned int maxThreads) {
+    auto run = [&] (const char* label, const std::string& a) {
+        std::mt19937 rng(1234); 
+        auto permuted = a; 
+        std::shuffle(permuted.begin(), permuted.end(), rng); 
+
+        auto changed = permuted; 
+        changed[length / 2] = (char) (changed[length / 2] + 1); 
+
+        auto gbPerSecond = [&] (double ms) { return 2.0 * length / (ms / 1000.0) / 1e9; }; 
+
+        std::cout << "CheckPermutation, " << length / (1024 * 1024) << " MB " << label << "\n"; 
+
+        auto report = [&] (const char* name, std::function<bool(const std::string&, const std::string&)> check) {
+            bool same = false; 
+            bool different = true; 
+            auto time = TimeMs([&] { same = check(a, permuted); }); 
+            time += TimeMs([&] { different = check(a, changed); }); 
+
+            std::cout << "  " << name << ": " << gbPerSecond(time / 2) << " GB/s" << (same && !different ? "" : " Error!") << "\n"; 
+        }; 
+
+        report("CheckPermutation (char tables)", [] (const std::string& x, const std::string& y) { return CheckPermutation(x, y); }); 
+        report("one histogram                 ", [] (const std::string& x, const std::string& y) { return CheckPermutation2<1>(x.data(), x.length(), y.data(), y.length()); }); 
+        report("CheckPermutation2 (4 tables)  ", [] (const std::string& x, const std::string& y) { return CheckPermutation2(x, y); }); 
+
+        for (unsigned int threads = 2; threads <= maxThreads; threads *= 2) {
+            report(("parallel " + std::to_string(threads) + " threads            ").c_str(), [threads] (const std::string& x, const std::string& y) { 
+                return CheckPermutationParallel(x.data(), x.length(), y.data(), y.length(), threads); 
+            }); 
+        }
+    }; 
+
+    std::mt19937 rng(1234); 
+    std::string random(length, 0); 
+    for (auto& c : random) { c = (char) rng(); }
+    run("random bytes", random); 
+
+    std::string runs(length, 'a'); 
+    for (size_t i = 0; i < length; i += 64) { runs[i] = (char) rng(); }
+    run("mostly 'a'", runs); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkURLify
+// Desc: lots of short request paths with some spaces, then one long string with a space every 
+// 8 characters where inserting shifts the whole tail every time. The caller buffer version reuses 
+// one buffer for everything
+//------------------------------------------------------------------------------------------------------
+void BenchmarkURLify(size_t pathCount, size_t longLength) {
+    std::mt19937 rng(1234); 
+    const char* alphabet = "abcdefghijklmnopqrstuvwxyz0123456789/ "; 
+
+    std::vector<std::string> paths(pathCount); 
+    size_t bytes = 0; 
+    for (auto& path : paths) {
+        path.resize(20 + rng() % 100); 
+        for (auto& c : path) { c = alphabet[rng() % 38]; }
+        bytes += path.length(); 
+    }
+
+    auto mbPerSecond = [] (size_t n, double ms) { return n / (ms / 1000.0) / 1e6; }; 
+
+    // each path gets copied into the same string so after the first few there's no allocating, 
+    // (fresh strings would mostly be timing malloc and page faults)
+    std::string work; 
+    size_t oldHash = 0; 
+    size_t newHash = 0; 
+
+    auto oldTime = TimeMs([&] { for (auto& path : paths) { work = path; URLify(work); oldHash += std::hash<std::string>()(work); } }); 
+    auto newTime = TimeMs([&] { for (auto& path : paths) { work = path; URLify2(work); newHash += std::hash<std::string>()(work); } }); 
+    size_t copyHash = 0; 
+    auto copyTime = TimeMs([&] { for (auto& path : paths) { work = path; copyHash += std::hash<std::string>()(work); } }); 
+
+    size_t encodedBytes = 0; 
+    UnreservedTable pathTable("/"); 
+    auto encodeTime = TimeMs([&] { for (auto& path : paths) { encodedBytes += PercentEncode(path, pathTable).length(); } }); 
+
+    std::vector<char> buffer(64); 
+    auto bufferTime = TimeMs([&] { 
+        for (auto& path : paths) { 
+            auto length = PercentEncode(path.data(), path.length(), buffer.data(), buffer.size(), pathTable); 
+            if (length > buffer.size()) {
+                buffer.resize(length * 2); 
+                PercentEncode(path.data(), path.length(), buffer.data(), buffer.size(), pathTable); 
+            }
+        } 
+    }); 
+
+    std::cout << "URLify, " << pathCount << " paths (" << bytes / (1024 * 1024) << " MB), copying and hashing them takes " << copyTime << " ms\n"; 
+    std::cout << "  URLify (insert):      " << mbPerSecond(bytes, oldTime) << " MB/s\n"; 
+    std::cout << "  URLify2 (backwards):  " << mbPerSecond(bytes, newTime) << " MB/s, same output: " << (oldHash == newHash) << "\n"; 
+    std::cout << "  PercentEncode string: " << mbPerSecond(bytes, encodeTime) << " MB/s (" << encodedBytes / (1024 * 1024) << " MB out)\n"; 
+    std::cout << "  PercentEncode buffer: " << mbPerSecond(bytes, bufferTime) << " MB/s\n"; 
+
+    std::string longString(longLength, 'a'); 
+    for (size_t i = 7; i < longLength; i += 8) { longString[i] = ' '; }
+
+    auto longCopy = longString; 
+    auto longOld = TimeMs([&] { URLify(longCopy); }); 
+    auto longNew = TimeMs([&] { URLify2(longString); }); 
+
+    std::cout << "  " << longLength / 1024 << " KB with " << longLength / 8 << " spaces: URLify " << longOld << " ms, URLify2 " << longNew 
+        << " ms, same output: " << (longCopy == longString) << "\n"; 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkPalindromePermutation
+// Desc: short phrases with spaces where half of them are palindrome permutations (a random half 
+// mirrored then shuffled) and one long string of random bytes. The UTF-8 run has every other 
+// character from a few thousand code points above ASCII
+//------------------------------------------------------------------------------------------------------
+void BenchmarkPalindromePermutation(size_t phraseCount, size_t longLength) {
+    std::mt19937 rng(1234); 
+    const char* alphabet = "abcdefghijklmnopqrstuvwxyz "; 
+
+    std::vector<std::string> phrases(phraseCount); 
+    size_t bytes = 0; 
+    for (size_t p = 0; p < phraseCount; p++) {
+        std::string half(4 + rng() % 16, 0); 
+        for (auto& c : half) { c = alphabet[rng() % 27]; }
+
+        auto& phrase = phrases[p]; 
+        phrase = half + (p % 2 ? std::string(half.rbegin(), half.rend()) : half.substr(1) + "q"); 
+        std::shuffle(phrase.begin(), phrase.end(), rng); 
+        bytes += phrase.length(); 
+    }
+
+    auto mbPerSecond = [] (size_t n, double ms) { return n / (ms / 1000.0) / 1e6; }; 
+
+    size_t counts[3] = {0, 0, 0}; 
+    auto oldTime = TimeMs([&] { for (auto& phrase : phrases) { counts[0] += IsPermutationOfPalindrome(phrase); } }); 
+    auto maskTime = TimeMs([&] { for (auto& phrase : phrases) { counts[1] += IsPermutationOfPalindrome2(phrase); } }); 
+    auto utf8Time = TimeMs([&] { for (auto& phrase : phrases) { counts[2] += IsPermutationOfPalindromeUtf8(phrase); } }); 
+
+    std::cout << "IsPermutationOfPalindrome, " << phraseCount << " phrases of 8-40 characters\n"; 
+    std::cout << "  table:       " << mbPerSecond(bytes, oldTime) << " MB/s, " << counts[0] << " palindromes\n"; 
+    std::cout << "  parity mask: " << mbPerSecond(bytes, maskTime) << " MB/s, " << counts[1] << " palindromes\n"; 
+    std::cout << "  utf8:        " << mbPerSecond(bytes, utf8Time) << " MB/s, " << counts[2] << " palindromes\n"; 
+
+    std::string random(longLength, 0); 
+    for (auto& c : random) { c = (char) rng(); }
+
+    bool results[3]; 
+    oldTime = TimeMs([&] { results[0] = IsPermutationOfPalindrome(random); }); 
+    maskTime = TimeMs([&] { results[1] = IsPermutationOfPalindrome2(random); }); 
+    utf8Time = TimeMs([&] { results[2] = IsPermutationOfPalindromeUtf8(random); }); 
+
+    std::cout << "  " << longLength / (1024 * 1024) << " MB random bytes: table " << mbPerSecond(longLength, oldTime) << " MB/s, parity mask " 
+        << mbPerSecond(longLength, maskTime) << " MB/s, utf8 " << mbPerSecond(longLength, utf8Time) << " MB/s, results " 
+        << results[0] << results[1] << results[2] << "\n"; 
+
+    // ascii letters and 2 or 3 byte code points taking turns
+    std::string text; 
+    size_t characters = 0; 
+    while (text.length() < longLength) {
+        text += alphabet[rng() % 26]; 
+        uint32_t codePoint = 0x100 + rng() % 4096; 
+        if (codePoint < 0x800) {
+            text += (char) (0xc0 | (codePoint >> 6)); 
+        } else {
+            text += (char) (0xe0 | (codePoint >> 12)); 
+            text += (char) (0x80 | ((codePoint >> 6) & 0x3f)); 
+        }
+        text += (char) (0x80 | (codePoint & 0x3f)); 
+        characters += 2; 
+    }
+
+    auto textTime = TimeMs([&] { results[2] = IsPermutationOfPalindromeUtf8(text); }); 
+    std::cout << "  " << text.length() / (1024 * 1024) << " MB of UTF-8 text: " << mbPerSecond(text.length(), textTime) << " MB/s, " 
+        << characters / (textTime * 1000.0) << " M characters/s\n"; 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkBatch
+// Desc: each batch call on a packed column against looping over a vector of std::strings with the 
+// one string versions, for short records. The batch calls run once on 1 thread and once on 
+// however many the machine has
+//------------------------------------------------------------------------------------------------------
+void BenchmarkBatch(size_t count) {
+    auto strs = GenerateStrings(count, 4, 24, 27); 
+    for (auto& str : strs) { std::replace(str.begin(), str.end(), (char) ('a' + 26), ' '); }
+
+    // every other record of others is a shuffled copy
+    std::mt19937 rng(1234); 
+    auto others = GenerateStrings(count, 4, 24, 27, 'a', 4321); 
+    for (size_t i = 0; i < count; i += 2) { others[i] = strs[i]; std::shuffle(others[i].begin(), others[i].end(), rng); }
+    for (auto& str : others) { std::replace(str.begin(), str.end(), (char) ('a' + 26), ' '); }
+
+    auto column = ToStringColumn(strs); 
+    auto otherColumn = ToStringColumn(others); 
+    auto threads = std::max(1u, std::thread::hardware_concurrency()); 
+
+    std::cout << "Batch, " << count << " records of 4-24 characters (" << column.data.size() / (1024 * 1024) << " MB), " << threads << " threads\n"; 
+
+    std::vector<uint64_t> bitmap; 
+    auto report = [&] (const char* name, double loopTime, size_t loopCount, std::function<size_t(unsigned int)> batch) {
+        size_t counts[2]; 
+        auto oneTime = TimeMs([&] { counts[0] = batch(1); }); 
+        auto allTime = TimeMs([&] { counts[1] = batch(threads); }); 
+
+        std::cout << "  " << name << ": loop " << count / (loopTime * 1000.0) << ", batch " << count / (oneTime * 1000.0) << ", batch " << threads 
+            << " threads " << count / (allTime * 1000.0) << " M records/s, " << counts[1] 
+            << (counts[0] == loopCount && counts[1] == loopCount ? "" : " Error!") << "\n"; 
+    }; 
+
+    size_t loopCount = 0; 
+    auto loopTime = TimeMs([&] { for (auto& str : strs) { loopCount += IsUnique2(str); } }); 
+    report("IsUnique                 ", loopTime, loopCount, [&] (unsigned int t) { return IsUniqueBatch(column.View(), bitmap, t); }); 
+
+    loopCount = 0; 
+    loopTime = TimeMs([&] { for (size_t i = 0; i < count; i++) { loopCount += CheckPermutation(strs[i], others[i]); } }); 
+    report("CheckPermutation         ", loopTime, loopCount, [&] (unsigned int t) { return CheckPermutationBatch(column.View(), otherColumn.View(), bitmap, t); }); 
+
+    loopCount = 0; 
+    loopTime = TimeMs([&] { for (auto& str : strs) { loopCount += IsPermutationOfPalindrome(str); } }); 
+    report("IsPermutationOfPalindrome", loopTime, loopCount, [&] (unsigned int t) { return IsPermutationOfPalindromeBatch(column.View(), bitmap, false, t); }); 
+
+    // URLify counts output bytes to compare
+    loopCount = 0; 
+    std::string work; 
+    loopTime = TimeMs([&] { for (auto& str : strs) { work = str; URLify2(work); loopCount += work.length(); } }); 
+    report("URLify (bytes out)       ", loopTime, loopCount, [&] (unsigned int t) { return URLifyBatch(column.View(), t).data.size(); }); 
+
+    OwnedStringColumn out; 
+    URLifyBatch(column.View(), out); 
+    report("URLify reusing the column", loopTime, loopCount, [&] (unsigned int t) { URLifyBatch(column.View(), out, t); return out.data.size(); }); 
+}
+
+//------------------------------------------------------------------------------------------------------
+// Name: BenchmarkStringViews
+// Desc: records of 4-40 characters one after another in a buffer, like lines from a file or a 
+// network read. The copying way makes a std::string for each one to call the functions and gets a 
+// std::string back from PercentEncode, the string_view way passes views and reuses one output buffer
+//------------------------------------------------------------------------------------------------------
+void BenchmarkStringViews(size_t count) {
+    std::string buffer; 
+    for (auto& str : GenerateStrings(count, 4, 40, 27)) { buffer += str; buffer += '\n'; }
+    std::replace(buffer.begin(), buffer.end(), (char) ('a' + 26), ' '); 
+
+    auto forEachRecord = [&] (auto f) {
+        for (size_t begin = 0; begin < buffer.length(); ) {
+            auto end = buffer.find('\n', begin); 
+            f(buffer.data() + begin, end - begin); 
+            begin = end + 1; 
+        }
+    }; 
+
+    size_t results[2] = {0, 0}; 
+
+    auto copying = [&] { 
+        forEachRecord([&] (const char* data, size_t length) {
+            std::string record(data, length); 
+            results[0] += IsUnique3(record) + IsPermutationOfPalindrome2(record) + CheckPermutation(record, record); 
+
+            auto url = record; 
+            URLify2(url); 
+            results[0] += url.length() + PercentEncode(record).length(); 
+        }); 
+    }; 
+
+    std::vector<char> out(64); 
+    auto views = [&] { 
+        forEachRecord([&] (const char* data, size_t length) {
+            std::string_view record(data, length); 
+            results[1] += IsUnique3(record) + IsPermutationOfPalindrome2(record) + CheckPermutation(record, record); 
+
+            // records are at most 40 so 64 is always enough for URLify, PercentEncode could need 120
+            results[1] += URLify(record, out.data(), out.size()); 
+            auto encodedLength = PercentEncode(record, out.data(), out.size()); 
+            if (encodedLength > out.size()) {
+                out.resize(encodedLength * 2); 
+                PercentEncode(record, out.data(), out.size()); 
+            }
+            results[1] += encodedLength; 
+        }); 
+    }; 
+
+    double times[2] = {TimeMs(copying), TimeMs(views)}; 
+    size_t allocations[2] = {CountAllocations(copying), CountAllocations(views)}; 
+
+    std::cout << "string_view, " << count << " records of 4-40 characters (" << buffer.length() / (1024 * 1024) << " MB)\n"; 
+    std::cout << "  copying into std::string: " << times[0] << " ms, " << allocations[0] << " allocations\n"; 
+    std::cout << "  std::string_view:         " << times[1] << " ms, " << allocations[1] << " allocations" 
+        << (results[0] == results[1] ? "" : " Error!") << "\n"; 
+}
+
 //------------------------------------------------------------------------------------------------------
 // Name:
 // Desc: 
@@ -171,6 +1311,21 @@ int main() {
         std::cout << unique3 << " is not unique\n"; 
     }
 
+//------------------------------------------------------------------------------------------------------
+    std::cout << " ---- IsUnique3() ---- \n"; 
+
+    // bytes >= 0x80 used to index IsUnique2's table with a negative number
+    std::string unique4 = "\xe9\xe8\xe0\x80"; 
+    std::string unique5 = "abc\xe9\xe8\xe9"; 
+
+    for (auto& str : {unique1, unique2, unique3, unique4, unique5}) {
+        if (IsUnique3(str)) {
+            std::cout << str << " is unique\n"; 
+        } else {
+            std::cout << str << " is not unique\n"; 
+        }
+    }
+
 //-------------------------------------------------------------------------------------------------------
 
     std::cout << " ---- CheckPermutation() ---- \n";
@@ -191,5 +1346,64 @@ int main() {
         std::cout << a << " & " << c << " are not permutations\n"; 
     }
 
+    // 256 'x's against 256 'y's, the char tables both wrap round to 0
+    std::string xs(256, 'x'); 
+    std::string ys(256, 'y'); 
+    std::cout << "CheckPermutation: " << CheckPermutation(xs, ys) << ", CheckPermutation2: " << CheckPermutation2(xs, ys) << "\n"; 
+
+//-------------------------------------------------------------------------------------------------------
+
+    std::cout << " ---- URLify() ---- \n";
+
+    // the book's version, room for the %20s at the end already
+    char title[] = "Mr John Smith    "; 
+    auto titleLength = URLify(title, 13); 
+    std::cout << std::string(title, titleLength) << "\n"; 
+
+    std::string url = "Mr John Smith"; 
+    URLify2(url); 
+    std::cout << url << "\n"; 
+
+    std::cout << PercentEncode("/a path/with spaces & ~stuff\xe9", UnreservedTable("/")) << "\n"; 
+
+//-------------------------------------------------------------------------------------------------------
+
+    std::cout << " ---- IsPermutationOfPalindrome() ---- \n";
+
+    for (std::string phrase : {"tact coa", "tact  boa", "ab a", "a", "\xc3\xa9t\xc3\xa9", "\xc3\xa9t\xc3\xa8"}) {
+        std::cout << phrase << ": " << IsPermutationOfPalindrome(phrase) << IsPermutationOfPalindrome2(phrase) 
+            << IsPermutationOfPalindromeUtf8(phrase) << "\n"; 
+    }
+
+//-------------------------------------------------------------------------------------------------------
+
+    std::cout << " ---- Batch ---- \n";
+
+    auto column = ToStringColumn({"abc", "tact coa", "aab", "Mr John Smith", ""}); 
+    auto shuffled = ToStringColumn({"cba", "taco cat", "abb", "Smith John Mr", ""}); 
+    std::vector<uint64_t> bitmap; 
+
+    auto printBitmap = [&] (const char* name, size_t setCount) {
+        std::cout << name << ": "; 
+        for (size_t i = 0; i < column.View().count; i++) { std::cout << BitmapGet(bitmap, i); }
+        std::cout << " (" << setCount << " set)\n"; 
+    }; 
+
+    printBitmap("IsUniqueBatch                 ", IsUniqueBatch(column.View(), bitmap)); 
+    printBitmap("CheckPermutationBatch         ", CheckPermutationBatch(column.View(), shuffled.View(), bitmap)); 
+    printBitmap("IsPermutationOfPalindromeBatch", IsPermutationOfPalindromeBatch(column.View(), bitmap)); 
+
+    auto urls = URLifyBatch(column.View()); 
+    for (size_t i = 0; i < urls.View().count; i++) { std::cout << "[" << urls.View()[i] << "] "; }
+    std::cout << "\n"; 
+
+
+    BenchmarkIsUnique(1000000); 
+    BenchmarkCheckPermutation(64 * 1024 * 1024, 4); 
+    BenchmarkURLify(1000000, 256 * 1024); 
+    BenchmarkPalindromePermutation(1000000, 64 * 1024 * 1024); 
+    BenchmarkBatch(4000000); 
+    BenchmarkStringViews(4000000); 
+
     return 0; 
 }
\ No newline at end of file
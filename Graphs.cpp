@@ -6,10 +6,36 @@
 #include <algorithm>
 #include <unordered_set>
 #include <unordered_map>
+#include <tuple>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include <numeric>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+// for LoadEdgeList
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 struct Node {
     // constructing the graph might take a little bit longer but algorithms on the graph will be faster
     std::vector<Node*> children; 
+    std::vector<uint32_t> weights; // weight of each edge in children, empty means they all weigh 1
     std::string name; 
 }; 
 
@@ -19,8 +45,12 @@ struct Graph {
 }; 
 
 // NOTE: remember that a graph might be stored like the following
+// KeyedGraph is the same thing for any key type, see FromKeyedGraph for turning it into a CsrGraph
+template<typename Key>
+using KeyedGraph = std::unordered_map<Key, std::tuple<std::string, std::unordered_set<Key>>>; 
+
 typedef uint16_t NodeKey; 
-std::unordered_map<NodeKey, std::tuple<std::string, std::unordered_set<NodeKey>>> alternateGraph; 
+KeyedGraph<NodeKey> alternateGraph; 
 
 //------------------------------------------------------------------------------------
 // Name: FromAdjacencyMatrix 
@@ -35,6 +65,7 @@ void FromAdjacencyMatrix(Graph& graph, uint8_t* adjacencyMatrix, std::vector<std
 
     // cant really do better than O(n^2) here i think? 
     // we need to iterate through the whole matrix
+    // (FromBitPackedAdjacencyMatrix is still O(n^2) but does 64 cells at a time)
     for (auto i = 0; i < nodeCount; i++) {        
         for (auto j = 0; j < nodeCount; j++) {
             if (j == i) continue; // i-th node cant connect to itself
@@ -49,127 +80,4471 @@ void FromAdjacencyMatrix(Graph& graph, uint8_t* adjacencyMatrix, std::vector<std
     }
 }
 
-// Chapter 4 
-// Breadth First Search
-// O(n) memory (i think? worst case we store a pointer to each node...)
-// O(n) complexity 
+// Depth first search
+// possible use is in simulations for example where 
+// visited is how many of a node's children we've looked at, carry on from there when we get back to 
+// it instead of going through them all again (that was O(d^2) for a node with d children). 
+// Goes through every node so disconnected parts get printed too 
 //
-bool BreadthFirstSearch(const Graph& graph, const Node* start = nullptr, const Node* find = nullptr) {
-    std::deque<const Node*> queue; 
-    std::unordered_set<const Node*> visited; 
-
-    if (start) {
-        // assuming start is in graph.nodes
-        auto result = std::find_if(graph.nodes.begin(), graph.nodes.end(), [start] (const Node& n) {return &n == start; } ); 
-        
-        if (result != graph.nodes.end()) {    
-            queue.push_back(start); 
-            visited.insert(start); 
-        } else {
-            return false; 
+void DepthFirstSearch(const Graph& graph) {
+    if (graph.nodes.size() == 0) { return; }
+    
+    std::unordered_set<const Node*> visitedNodes; 
+    std::vector<std::tuple<const Node*, unsigned int>> stack; 
+
+    for (auto& root : graph.nodes) {
+        if (!visitedNodes.insert(&root).second) { continue; }
+
+        stack.push_back(std::tuple<const Node*, unsigned int>(&root, 0)); 
+
+        while (!stack.empty()) {
+            auto& top = stack.back(); 
+            auto& visited = std::get<1>(top); 
+            auto currentNode = std::get<0>(top); 
+
+            if (visited == 0) {
+                std::cout << currentNode->name << " "; 
+            }
+
+            if (visited < currentNode->children.size()) {
+                while (visited < currentNode->children.size()) {
+                    auto node = currentNode->children[visited++]; 
+                    if (visitedNodes.insert(node).second) {
+                        stack.push_back(std::tuple<const Node*, unsigned int>(node, 0)); 
+                        break; 
+                    }
+                }
+            } else {
+                stack.pop_back(); 
+            }
         }
+    }
 
-    } else {
+    std::cout << "\n"; 
+}
+
+
+//------------------------------------------------------------------------------------
+// CsrGraph
+// Compressed sparse row version of Graph. All the children of every node are packed into one 
+// targets array and node i's children are targets[offsets[i]] .. targets[offsets[i + 1] - 1].
+// Nodes are 32 bit ids instead of pointers so a BFS step is reading a couple of contiguous arrays
+// instead of chasing a pointer into a separate heap block for every node.
+// 
+// names are kept separately because traversals never need them, they can be empty (generated graphs)
+//------------------------------------------------------------------------------------
+typedef uint32_t NodeId; 
+typedef uint64_t EdgeIndex; 
+typedef uint32_t Weight; 
+typedef std::tuple<NodeId, NodeId> Edge; 
+typedef std::tuple<NodeId, NodeId, Weight> WeightedEdge; 
 
-        visited.insert(&graph.nodes[0]);
-        queue.push_back(&graph.nodes[0]); 
+const NodeId InvalidNode = 0xffffffff; 
+
+struct CsrGraph {
+    std::vector<EdgeIndex> offsets; // NodeCount() + 1 entries
+    std::vector<NodeId> targets; 
+    std::vector<Weight> weights;    // same order as targets, empty means every edge weighs 1
+    std::vector<std::string> names; 
+
+    NodeId NodeCount() const { return offsets.empty() ? 0 : (NodeId) (offsets.size() - 1); }
+    EdgeIndex EdgeCount() const { return targets.size(); }
+    EdgeIndex Degree(NodeId node) const { return offsets[node + 1] - offsets[node]; }
+
+    const NodeId* ChildrenBegin(NodeId node) const { return targets.data() + offsets[node]; }
+    const NodeId* ChildrenEnd(NodeId node) const { return targets.data() + offsets[node + 1]; }
+    Weight WeightAt(EdgeIndex edge) const { return weights.empty() ? 1 : weights[edge]; }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: FromAdjacencyMatrix 
+// Desc: same input as the Graph version, count each row first so targets is allocated once
+//------------------------------------------------------------------------------------
+void FromAdjacencyMatrix(CsrGraph& graph, const uint8_t* adjacencyMatrix, const std::vector<std::string>& values, uint32_t nodeCount) {
+    graph.offsets.assign(nodeCount + 1, 0); 
+    graph.weights.clear(); 
+    graph.targets.clear(); 
+    graph.names = values; 
+    graph.names.resize(nodeCount); 
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        EdgeIndex degree = 0; 
+        for (uint32_t j = 0; j < nodeCount; j++) {
+            degree += (j != i) && adjacencyMatrix[(size_t) i * nodeCount + j]; 
+        }
+
+        graph.offsets[i + 1] = graph.offsets[i] + degree; 
     }
 
-    while (!queue.empty()) {
-        auto top = queue.front(); 
-        queue.pop_front();
-        std::cout << top->name << " "; 
+    graph.targets.resize(graph.offsets[nodeCount]); 
 
-        for (auto child : top->children) {
-            if (visited.find(child) == visited.end()) {
-                visited.insert(child);  
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        auto out = graph.targets.data() + graph.offsets[i]; 
+        for (uint32_t j = 0; j < nodeCount; j++) {
+            if (j == i) continue; // i-th node cant connect to itself
 
-                if (find && (child == find)) {
-                    std::cout << child->name << "\n";
-                    return true; 
-                }
+            if (adjacencyMatrix[(size_t) i * nodeCount + j]) {
+                *out++ = j; 
+            }
+        }
+    }
+}
 
-                queue.push_back(child); 
+// true if both ends of every edge are < nodeCount, works for Edge and WeightedEdge
+template<typename EdgeType>
+bool EdgesInRange(const std::vector<EdgeType>& edges, NodeId nodeCount) {
+    return std::all_of(edges.begin(), edges.end(), [nodeCount] (const EdgeType& edge) { 
+        return std::get<0>(edge) < nodeCount && std::get<1>(edge) < nodeCount; 
+    }); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: FromEdgeList 
+// Desc: counting sort on the source node, O(V + E) and targets is allocated once. 
+// Edges keep their order within a node, self loops are dropped like in FromAdjacencyMatrix. 
+// Returns false (and leaves graph alone) if an edge has an id >= nodeCount
+//------------------------------------------------------------------------------------
+bool FromEdgeList(CsrGraph& graph, const std::vector<Edge>& edges, NodeId nodeCount, const std::vector<std::string>& names = {}) {
+    if (!EdgesInRange(edges, nodeCount)) { return false; }
+
+    graph.offsets.assign(nodeCount + 1, 0); 
+    graph.weights.clear(); 
+    graph.names = names; 
+    graph.names.resize(nodeCount); 
+
+    for (auto& edge : edges) {
+        if (std::get<0>(edge) != std::get<1>(edge)) {
+            graph.offsets[std::get<0>(edge) + 1]++; 
+        }
+    }
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        graph.offsets[i + 1] += graph.offsets[i]; 
+    }
+
+    graph.targets.resize(graph.offsets[nodeCount]); 
+
+    // next free slot for each node
+    std::vector<EdgeIndex> cursor(graph.offsets.begin(), graph.offsets.end() - 1); 
+
+    for (auto& edge : edges) {
+        auto from = std::get<0>(edge); 
+        auto to = std::get<1>(edge); 
+
+        if (from != to) {
+            graph.targets[cursor[from]++] = to; 
+        }
+    }
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: FromEdgeList 
+// Desc: Graph version, mostly so the benchmarks can build the same big graph in both forms. 
+// Returns false (and leaves graph alone) if an edge has an id >= nodeCount
+//------------------------------------------------------------------------------------
+bool FromEdgeList(Graph& graph, const std::vector<Edge>& edges, NodeId nodeCount, const std::vector<std::string>& names = {}) {
+    if (!EdgesInRange(edges, nodeCount)) { return false; }
+
+    graph.nodes.clear(); 
+    graph.nodes.resize(nodeCount); 
+
+    for (size_t i = 0; i < names.size() && i < nodeCount; i++) {
+        graph.nodes[i].name = names[i]; 
+    }
+
+    for (auto& edge : edges) {
+        auto from = std::get<0>(edge); 
+        auto to = std::get<1>(edge); 
+
+        if (from != to) {
+            graph.nodes[from].children.push_back(&graph.nodes[to]); 
+        }
+    }
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// VisitedBitmap
+// One bit per node for the visited set instead of hashing pointers into an unordered_set. 
+// Clearing the bitmap before every search would be O(V) even when the search only touches a few
+// nodes, so each 64 bit word also remembers the generation (search) that last wrote it and a word
+// from an older generation reads as all zeros. Reset() just bumps the generation. 
+//------------------------------------------------------------------------------------
+struct VisitedBitmap {
+    std::vector<uint64_t> words; 
+    std::vector<uint32_t> wordGenerations; 
+    uint32_t generation = 0; 
+
+    // start a new search over nodeCount nodes, O(1) unless the size changed or the generation wrapped
+    void Reset(NodeId nodeCount) {
+        size_t wordCount = ((size_t) nodeCount + 63) / 64; 
+
+        if (words.size() != wordCount) {
+            words.assign(wordCount, 0); 
+            wordGenerations.assign(wordCount, 0); 
+            generation = 0; 
+        }
+
+        generation++; 
+
+        if (generation == 0) {
+            std::fill(wordGenerations.begin(), wordGenerations.end(), 0); 
+            generation = 1; 
+        }
+    }
+
+    bool Test(NodeId node) const {
+        auto word = node >> 6; 
+        return wordGenerations[word] == generation && (words[word] & (1ull << (node & 63))); 
+    }
+
+    // sets the bit and returns true if it wasnt already set
+    bool TestAndSet(NodeId node) {
+        auto word = node >> 6; 
+        auto bit = 1ull << (node & 63); 
+
+        if (wordGenerations[word] != generation) {
+            wordGenerations[word] = generation; 
+            words[word] = bit; 
+            return true; 
+        }
+
+        if (words[word] & bit) { return false; }
+
+        words[word] |= bit; 
+        return true; 
+    }
+}; 
+
+// SearchScratch
+// memory for a search that can be kept around and reused so repeated queries dont allocate
+struct SearchScratch {
+    VisitedBitmap visited; 
+    std::vector<NodeId> queue; // flat array queue, every node goes in at most once so it never needs to grow
+    size_t visitedCount = 0;   // how many nodes the last search visited
+
+    void Reset(NodeId nodeCount) {
+        visited.Reset(nodeCount); 
+        if (queue.size() < nodeCount) { queue.resize(nodeCount); }
+    }
+}; 
+
+// Breadth First Search over a CsrGraph 
+// returns true if find is reachable from start, doesnt print anything so it can be timed
+// O(V + E) complexity, O(V) memory
+//
+bool BreadthFirstSearch(const CsrGraph& graph, NodeId start, NodeId find, SearchScratch& scratch) {
+    if (start >= graph.NodeCount()) { return false; }
+    if (start == find) { scratch.visitedCount = 1; return true; }
+
+    scratch.Reset(graph.NodeCount()); 
+
+    auto& visited = scratch.visited; 
+    auto queue = scratch.queue.data(); 
+    size_t head = 0; 
+    size_t tail = 0; 
+
+    queue[tail++] = start; 
+    visited.TestAndSet(start); 
+
+    while (head < tail) {
+        auto top = queue[head++]; 
+
+        for (auto child = graph.ChildrenBegin(top); child != graph.ChildrenEnd(top); child++) {
+            if (visited.TestAndSet(*child)) {
+                if (*child == find) { scratch.visitedCount = tail + 1; return true; }
+
+                queue[tail++] = *child; 
             }
         }
     }
 
-    std::cout << "\n";
+    scratch.visitedCount = tail; 
+    return false; 
+}
+
+bool BreadthFirstSearch(const CsrGraph& graph, NodeId start, NodeId find = InvalidNode) {
+    SearchScratch scratch; 
+    return BreadthFirstSearch(graph, start, find, scratch); 
+}
+
+// Breadth First Search over a Graph using SearchScratch 
+// nodes are numbered by their position in graph.nodes so the bitmap works without touching Node. 
+// Unlike the first version the bitmap and queue get reused between searches
+//
+bool BreadthFirstSearch(const Graph& graph, const Node* start, const Node* find, SearchScratch& scratch) {
+    if (graph.nodes.empty()) { return false; }
+
+    auto first = graph.nodes.data(); 
+    if (start == nullptr) { start = first; }
+    if (start < first || start >= first + graph.nodes.size()) { return false; }
+    if (start == find) { scratch.visitedCount = 1; return true; }
+
+    scratch.Reset((NodeId) graph.nodes.size()); 
+
+    auto& visited = scratch.visited; 
+    auto queue = scratch.queue.data(); 
+    size_t head = 0; 
+    size_t tail = 0; 
+
+    queue[tail++] = (NodeId) (start - first); 
+    visited.TestAndSet(queue[0]); 
+
+    while (head < tail) {
+        auto& top = graph.nodes[queue[head++]]; 
+
+        for (auto child : top.children) {
+            auto id = (NodeId) (child - first); 
+
+            if (visited.TestAndSet(id)) {
+                if (child == find) { scratch.visitedCount = tail + 1; return true; }
+
+                queue[tail++] = id; 
+            }
+        }
+    }
 
+    scratch.visitedCount = tail; 
     return false; 
 }
 
-// Depth first search
-// possible use is in simulations for example where 
+// Depth first search over a CsrGraph
+// returns the nodes in the order they were discovered. Each stack frame keeps its position in
+// the node's children so a node is never rescanned from the start
 //
-void DepthFirstSearch(const Graph& graph) {
-    if (graph.nodes.size() == 0) { return; }
-    
-    std::unordered_set<const Node*> visitedNodes; 
-    std::vector<std::tuple<const Node*, unsigned int>> stack; 
-    stack.push_back(&graph.nodes[0]); 
+std::vector<NodeId> DepthFirstSearch(const CsrGraph& graph, NodeId start = 0) {
+    std::vector<NodeId> order; 
+    if (start >= graph.NodeCount()) { return order; }
+
+    std::vector<bool> visited(graph.NodeCount(), false); 
+    std::vector<std::tuple<NodeId, EdgeIndex>> stack; // node, next edge to look at 
+
+    visited[start] = true; 
+    order.push_back(start); 
+    stack.push_back(std::tuple<NodeId, EdgeIndex>(start, graph.offsets[start])); 
 
     while (!stack.empty()) {
         auto& top = stack.back(); 
-        auto& visited = std::get<1>(top); 
-        auto currentNode = std::get<0>(top); 
+        auto node = std::get<0>(top); 
+        auto& cursor = std::get<1>(top); 
 
-        if (visited == 0) {
-            std::cout << currentNode->name << " "; 
+        if (cursor == graph.offsets[node + 1]) {
+            stack.pop_back(); 
+            continue; 
         }
 
-        if (visited < currentNode->children.size()) {
-            for (auto node : currentNode->children) {
-                visited++; 
-                if (visitedNodes.find(node) == visitedNodes.end()) {
-                    visitedNodes.insert(node); 
-                    stack.push_back(std::tuple<const Node*, unsigned int>(node, 0)); 
-                    break; 
-                }
-            }
-        } else {
-            stack.pop_back(); 
+        auto child = graph.targets[cursor++]; 
+
+        if (!visited[child]) {
+            visited[child] = true; 
+            order.push_back(child); 
+            stack.push_back(std::tuple<NodeId, EdgeIndex>(child, graph.offsets[child])); 
         }
     }
 
-    std::cout << "\n"; 
+    return order; 
 }
 
 // 4.1
-// Route between nodes
-// Given a directed graph, design and algorithm to find out whether there is a route between two nodes
+// Route between nodes, CsrGraph version
 //
-bool RouteBetweenNodes(Graph& graph, const Node* node1, const Node* node2) {
-    return BreadthFirstSearch(graph, node1, node2);
+bool RouteBetweenNodes(const CsrGraph& graph, NodeId node1, NodeId node2) {
+    return BreadthFirstSearch(graph, node1, node2); 
+}
+
+// 4.1
+// Route between nodes, reusing the scratch memory between queries
+//
+bool RouteBetweenNodes(const Graph& graph, const Node* node1, const Node* node2, SearchScratch& scratch) {
+    return BreadthFirstSearch(graph, node1, node2, scratch); 
+}
+
+bool RouteBetweenNodes(const CsrGraph& graph, NodeId node1, NodeId node2, SearchScratch& scratch) {
+    return BreadthFirstSearch(graph, node1, node2, scratch); 
 }
 
 //------------------------------------------------------------------------------------
-// Name: main 
-// Desc:
+// Name: Transpose 
+// Desc: reverse every edge, children of a node in reverse are the nodes that point to it in graph.
+// weights go with their edges, names are not copied
 //------------------------------------------------------------------------------------
-int main() {
+void Transpose(CsrGraph& reverse, const CsrGraph& graph) {
+    auto nodeCount = graph.NodeCount(); 
 
-    uint8_t adjacencyMatrix[6][6] = 
-    {
-        {0, 1, 0, 0, 1, 1}, // 0 A
-        {0, 0, 0, 1, 1, 0}, // 1 B
-        {0, 1, 0, 0, 0, 0}, // 2 C
-        {0, 0, 1, 0, 1, 0}, // 3 D
-        {0, 0, 0, 0, 0, 0}, // 4 E
-        {0, 0, 0, 0, 0, 0}  // 5 F
-    }; 
+    reverse.offsets.assign(nodeCount + 1, 0); 
+    reverse.targets.resize(graph.EdgeCount()); 
+    reverse.weights.resize(graph.weights.empty() ? 0 : graph.EdgeCount()); 
+    reverse.names.clear(); 
 
-    std::vector<std::string> values = { "0", "1", "2", "3", "4", "5" };
+    for (auto target : graph.targets) {
+        reverse.offsets[target + 1]++; 
+    }
 
-    Graph graph;
-    FromAdjacencyMatrix(graph, (uint8_t*)adjacencyMatrix, values, 6); 
+    for (NodeId i = 0; i < nodeCount; i++) {
+        reverse.offsets[i + 1] += reverse.offsets[i]; 
+    }
 
-    BreadthFirstSearch(graph);
+    std::vector<EdgeIndex> cursor(reverse.offsets.begin(), reverse.offsets.end() - 1); 
 
-    auto result = BreadthFirstSearch(graph, &graph.nodes[2], &graph.nodes[4]);
-    std::cout << result << "\n";
+    for (NodeId from = 0; from < nodeCount; from++) {
+        for (auto edge = graph.offsets[from]; edge < graph.offsets[from + 1]; edge++) {
+            auto slot = cursor[graph.targets[edge]]++; 
+            reverse.targets[slot] = from; 
+            if (!graph.weights.empty()) { reverse.weights[slot] = graph.weights[edge]; }
+        }
+    }
+}
 
-    DepthFirstSearch(graph);
+// BfsTree
+// what a full BFS from one start node found, parent of start is itself
+const uint32_t Unreachable = 0xffffffff; 
+
+struct BfsTree {
+    std::vector<NodeId> parents;      // InvalidNode if not reached
+    std::vector<uint32_t> distances;  // Unreachable if not reached
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: TopDownBfs 
+// Desc: the normal queue based BFS but recording the parent and distance of every node 
+// O(V + E)
+//------------------------------------------------------------------------------------
+BfsTree TopDownBfs(const CsrGraph& graph, NodeId start) {
+    BfsTree tree; 
+    tree.parents.assign(graph.NodeCount(), InvalidNode); 
+    tree.distances.assign(graph.NodeCount(), Unreachable); 
+
+    if (start >= graph.NodeCount()) { return tree; }
+
+    std::vector<NodeId> queue(graph.NodeCount()); 
+    size_t head = 0; 
+    size_t tail = 0; 
+
+    queue[tail++] = start; 
+    tree.parents[start] = start; 
+    tree.distances[start] = 0; 
+
+    while (head < tail) {
+        auto top = queue[head++]; 
+
+        for (auto child = graph.ChildrenBegin(top); child != graph.ChildrenEnd(top); child++) {
+            if (tree.parents[*child] == InvalidNode) {
+                tree.parents[*child] = top; 
+                tree.distances[*child] = tree.distances[top] + 1; 
+                queue[tail++] = *child; 
+            }
+        }
+    }
+
+    return tree; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: DirectionOptimizingBfs 
+// Desc: Beamer, Asanovic, Patterson "Direction-Optimizing Breadth-First Search". 
+//
+// Top down (push) looks at every edge out of the frontier, which is wasteful in the middle levels 
+// of a small world graph where the frontier is huge and most of its edges point at nodes that 
+// are already visited. Bottom up (pull) instead goes through every unvisited node and looks 
+// at the edges coming into it, stopping as soon as it finds a parent in the frontier. 
+//
+// Switch to bottom up when the edges out of the frontier (mf) are more than 1/alpha of the edges
+// out of unvisited nodes (mu), switch back when the frontier gets smaller than V/beta. 
+// reverse is Transpose(graph), for an undirected (symmetric) graph it can just be graph. 
+//------------------------------------------------------------------------------------
+BfsTree DirectionOptimizingBfs(const CsrGraph& graph, const CsrGraph& reverse, NodeId start, double alpha = 15.0, double beta = 18.0) {
+    auto nodeCount = graph.NodeCount(); 
+
+    BfsTree tree; 
+    tree.parents.assign(nodeCount, InvalidNode); 
+    tree.distances.assign(nodeCount, Unreachable); 
+
+    if (start >= nodeCount) { return tree; }
+
+    auto wordCount = ((size_t) nodeCount + 63) / 64; 
+    std::vector<uint64_t> frontierBits(wordCount, 0); 
+    std::vector<uint64_t> nextBits(wordCount, 0); 
+    std::vector<NodeId> frontier; 
+    std::vector<NodeId> next; 
+
+    frontier.push_back(start); 
+    tree.parents[start] = start; 
+    tree.distances[start] = 0; 
+
+    EdgeIndex edgesToCheck = graph.EdgeCount() - graph.Degree(start); // mu 
+    EdgeIndex frontierEdges = graph.Degree(start); // mf 
+    size_t frontierSize = 1; 
+    uint32_t depth = 0; 
+    bool bottomUp = false; 
+
+    while (frontierSize > 0) {
+        if (!bottomUp && frontierEdges > edgesToCheck / alpha) {
+            // queue -> bitmap
+            std::fill(frontierBits.begin(), frontierBits.end(), 0); 
+            for (auto node : frontier) { frontierBits[node >> 6] |= 1ull << (node & 63); }
+            bottomUp = true; 
+        } else if (bottomUp && frontierSize < nodeCount / beta) {
+            // bitmap -> queue
+            frontier.clear(); 
+            for (size_t w = 0; w < wordCount; w++) {
+                for (auto bits = frontierBits[w]; bits; bits &= bits - 1) {
+                    frontier.push_back((NodeId) (w * 64 + __builtin_ctzll(bits))); 
+                }
+            }
+            bottomUp = false; 
+        }
+
+        depth++; 
+        frontierEdges = 0; 
+        frontierSize = 0; 
+
+        if (bottomUp) {
+            std::fill(nextBits.begin(), nextBits.end(), 0); 
+
+            for (NodeId node = 0; node < nodeCount; node++) {
+                if (tree.parents[node] != InvalidNode) { continue; }
+
+                for (auto parent = reverse.ChildrenBegin(node); parent != reverse.ChildrenEnd(node); parent++) {
+                    if (frontierBits[*parent >> 6] & (1ull << (*parent & 63))) {
+                        tree.parents[node] = *parent; 
+                        tree.distances[node] = depth; 
+                        nextBits[node >> 6] |= 1ull << (node & 63); 
+                        frontierEdges += graph.Degree(node); 
+                        frontierSize++; 
+                        break; 
+                    }
+                }
+            }
+
+            frontierBits.swap(nextBits); 
+        } else {
+            next.clear(); 
+
+            for (auto node : frontier) {
+                for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+                    if (tree.parents[*child] == InvalidNode) {
+                        tree.parents[*child] = node; 
+                        tree.distances[*child] = depth; 
+                        next.push_back(*child); 
+                        frontierEdges += graph.Degree(*child); 
+                    }
+                }
+            }
+
+            frontierSize = next.size(); 
+            frontier.swap(next); 
+        }
+
+        edgesToCheck -= std::min(edgesToCheck, frontierEdges); 
+    }
+
+    return tree; 
+}
+
+//------------------------------------------------------------------------------------
+// ThreadBarrier
+// every thread calls Wait() and nobody gets past it until all threadCount threads have arrived
+//------------------------------------------------------------------------------------
+struct ThreadBarrier {
+    std::mutex mutex; 
+    std::condition_variable condition; 
+    unsigned int threadCount; 
+    unsigned int waiting = 0; 
+    unsigned int generation = 0; 
+
+    explicit ThreadBarrier(unsigned int count) : threadCount(count) {}
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex); 
+        auto arrivedGeneration = generation; 
+
+        if (++waiting == threadCount) {
+            waiting = 0; 
+            generation++; 
+            condition.notify_all(); 
+        } else {
+            condition.wait(lock, [this, arrivedGeneration] { return generation != arrivedGeneration; }); 
+        }
+    }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: ParallelBfs 
+// Desc: level synchronous BFS, returns the distance of every node from start (Unreachable if not reached)
+//
+// Each level the threads grab chunks of the frontier off a shared counter (so a few huge hub nodes 
+// dont leave everyone else waiting) and claim children by setting their bit in a shared visited 
+// bitmap with compare and swap, only the thread that flips the bit owns the node. Newly claimed nodes go into
+// a per thread buffer and once everyone is done the buffers are copied into the next frontier. 
+// 3 barriers per level which is fine for small diameter graphs
+//------------------------------------------------------------------------------------
+std::vector<uint32_t> ParallelBfs(const CsrGraph& graph, NodeId start, unsigned int threadCount) {
+    auto nodeCount = graph.NodeCount(); 
+    std::vector<uint32_t> distances(nodeCount, Unreachable); 
+
+    if (start >= nodeCount) { return distances; }
+    if (threadCount == 0) { threadCount = 1; }
+
+    const size_t chunkSize = 64; 
+
+    std::vector<std::atomic<uint64_t>> visited(((size_t) nodeCount + 63) / 64); 
+    for (auto& word : visited) { word.store(0, std::memory_order_relaxed); }
+
+    std::vector<NodeId> frontiers[2]; 
+    frontiers[0].push_back(start); 
+    visited[start >> 6].store(1ull << (start & 63), std::memory_order_relaxed); 
+    distances[start] = 0; 
+
+    std::vector<std::vector<NodeId>> localNext(threadCount); 
+    std::vector<size_t> copyOffsets(threadCount + 1, 0); 
+    std::atomic<size_t> nextChunk(0); 
+    ThreadBarrier barrier(threadCount); 
+
+    auto worker = [&] (unsigned int threadIndex) {
+        auto& local = localNext[threadIndex]; 
+        unsigned int current = 0; 
+        uint32_t depth = 0; 
+
+        while (!frontiers[current].empty()) {
+            auto& frontier = frontiers[current]; 
+            depth++; 
+            local.clear(); 
+
+            // expand
+            while (true) {
+                auto begin = nextChunk.fetch_add(chunkSize, std::memory_order_relaxed); 
+                if (begin >= frontier.size()) { break; }
+                auto end = std::min(begin + chunkSize, frontier.size()); 
+
+                for (auto i = begin; i < end; i++) {
+                    auto node = frontier[i]; 
+
+                    for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+                        auto& word = visited[*child >> 6]; 
+                        auto bit = 1ull << (*child & 63); 
+                        auto old = word.load(std::memory_order_relaxed); 
+
+                        // someone else might set a different bit in the same word so keep trying 
+                        // until either our bit is set by someone or we set it 
+                        while (!(old & bit) && !word.compare_exchange_weak(old, old | bit, std::memory_order_relaxed)) {}
+
+                        if (!(old & bit)) {
+                            distances[*child] = depth; 
+                            local.push_back(*child); 
+                        }
+                    }
+                }
+            }
+
+            barrier.Wait(); 
+
+            // work out where each thread's buffer goes in the next frontier
+            if (threadIndex == 0) {
+                for (unsigned int t = 0; t < threadCount; t++) {
+                    copyOffsets[t + 1] = copyOffsets[t] + localNext[t].size(); 
+                }
+
+                frontiers[current ^ 1].resize(copyOffsets[threadCount]); 
+                nextChunk.store(0, std::memory_order_relaxed); 
+            }
+
+            barrier.Wait(); 
+
+            std::copy(local.begin(), local.end(), frontiers[current ^ 1].begin() + copyOffsets[threadIndex]); 
+            current ^= 1; 
+
+            barrier.Wait(); 
+        }
+    }; 
+
+    std::vector<std::thread> threads; 
+    for (unsigned int t = 1; t < threadCount; t++) {
+        threads.push_back(std::thread(worker, t)); 
+    }
+
+    worker(0); 
+
+    for (auto& thread : threads) { thread.join(); }
+
+    return distances; 
+}
+
+//------------------------------------------------------------------------------------
+// BidirectionalRouter
+// For point to point route queries. Searching forward from node1 until we hit node2 can end up 
+// exploring most of the graph, searching forward from node1 and backward from node2 at the same time 
+// and stopping when they meet usually touches far fewer nodes because each side only has to go 
+// about half the distance (think of two small circles instead of one big one).
+//
+// The backward search needs the reverse edges so Build() transposes the graph once up front. 
+// Each side keeps a parent per node that's only valid if its stamp matches the current query, 
+// so nothing needs to be cleared between queries. 
+//------------------------------------------------------------------------------------
+struct BidirectionalRouter {
+    const CsrGraph* graph = nullptr; 
+    CsrGraph reverse; 
+
+    std::vector<uint32_t> forwardStamps; 
+    std::vector<uint32_t> backwardStamps; 
+    std::vector<NodeId> forwardParents; 
+    std::vector<NodeId> backwardParents; // next node on the way to node2
+    std::vector<NodeId> forwardFrontier; 
+    std::vector<NodeId> backwardFrontier; 
+    std::vector<NodeId> next; 
+    uint32_t stamp = 0; 
+    size_t visitedCount = 0; // how many nodes the last query visited (both sides)
+
+    void Build(const CsrGraph& g) {
+        graph = &g; 
+        Transpose(reverse, g); 
+
+        forwardStamps.assign(g.NodeCount(), 0); 
+        backwardStamps.assign(g.NodeCount(), 0); 
+        forwardParents.resize(g.NodeCount()); 
+        backwardParents.resize(g.NodeCount()); 
+        stamp = 0; 
+    }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: ExpandLevel 
+// Desc: one level of BFS for one side of the bidirectional search, returns the node where it ran into the
+// other side or InvalidNode
+//------------------------------------------------------------------------------------
+NodeId ExpandLevel(const CsrGraph& edges, std::vector<NodeId>& frontier, std::vector<NodeId>& next, 
+    std::vector<uint32_t>& stamps, std::vector<NodeId>& parents, const std::vector<uint32_t>& otherStamps, uint32_t stamp, size_t& visitedCount) {
+    
+    next.clear(); 
+
+    for (auto node : frontier) {
+        for (auto child = edges.ChildrenBegin(node); child != edges.ChildrenEnd(node); child++) {
+            if (stamps[*child] == stamp) { continue; }
+
+            stamps[*child] = stamp; 
+            parents[*child] = node; 
+            visitedCount++; 
+
+            if (otherStamps[*child] == stamp) { return *child; }
+
+            next.push_back(*child); 
+        }
+    }
+
+    frontier.swap(next); 
+    return InvalidNode; 
+}
+
+// 4.1
+// Route between nodes, bidirectional version. Returns true if there is a route and if path isnt null 
+// fills it with the nodes on one route from node1 to node2 (including both). 
+// Expands whichever side has the smaller frontier each step
+//
+bool RouteBetweenNodes(BidirectionalRouter& router, NodeId node1, NodeId node2, std::vector<NodeId>* path = nullptr) {
+    auto& graph = *router.graph; 
+
+    // cleared first so a path from an earlier query never survives a false return
+    if (path) { path->clear(); }
+    if (node1 >= graph.NodeCount() || node2 >= graph.NodeCount()) { return false; }
+
+    router.stamp++; 
+    if (router.stamp == 0) {
+        std::fill(router.forwardStamps.begin(), router.forwardStamps.end(), 0); 
+        std::fill(router.backwardStamps.begin(), router.backwardStamps.end(), 0); 
+        router.stamp = 1; 
+    }
+
+    auto stamp = router.stamp; 
+
+    router.forwardStamps[node1] = stamp; 
+    router.forwardParents[node1] = InvalidNode; 
+    router.backwardStamps[node2] = stamp; 
+    router.backwardParents[node2] = InvalidNode; 
+    router.forwardFrontier.assign(1, node1); 
+    router.backwardFrontier.assign(1, node2); 
+    router.visitedCount = 2; 
+
+    auto meet = node1 == node2 ? node1 : InvalidNode; 
+
+    while (meet == InvalidNode && !router.forwardFrontier.empty() && !router.backwardFrontier.empty()) {
+        if (router.forwardFrontier.size() <= router.backwardFrontier.size()) {
+            meet = ExpandLevel(graph, router.forwardFrontier, router.next, router.forwardStamps, router.forwardParents, 
+                router.backwardStamps, stamp, router.visitedCount); 
+        } else {
+            meet = ExpandLevel(router.reverse, router.backwardFrontier, router.next, router.backwardStamps, router.backwardParents, 
+                router.forwardStamps, stamp, router.visitedCount); 
+        }
+    }
+
+    if (meet == InvalidNode) { return false; }
+
+    if (path) {
+        for (auto node = meet; node != InvalidNode; node = router.forwardParents[node]) {
+            path->push_back(node); 
+        }
+
+        std::reverse(path->begin(), path->end()); 
+
+        for (auto node = router.backwardParents[meet]; node != InvalidNode; node = router.backwardParents[node]) {
+            path->push_back(node); 
+        }
+    }
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: FromGraph 
+// Desc: Graph -> CsrGraph, node ids are positions in graph.nodes. Edge weights are copied if 
+// any node has them. Returns false (and leaves csr alone) if a node has weights but not one per child
+//------------------------------------------------------------------------------------
+bool FromGraph(CsrGraph& csr, const Graph& graph) {
+    auto nodeCount = (NodeId) graph.nodes.size(); 
+    auto first = graph.nodes.data(); 
+    auto weighted = std::any_of(graph.nodes.begin(), graph.nodes.end(), [] (const Node& node) { return !node.weights.empty(); }); 
+
+    auto badWeights = std::any_of(graph.nodes.begin(), graph.nodes.end(), [] (const Node& node) { 
+        return !node.weights.empty() && node.weights.size() != node.children.size(); 
+    }); 
+
+    if (badWeights) { return false; }
+
+    csr.offsets.assign(nodeCount + 1, 0); 
+    csr.names.resize(nodeCount); 
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        csr.offsets[i + 1] = csr.offsets[i] + graph.nodes[i].children.size(); 
+        csr.names[i] = graph.nodes[i].name; 
+    }
+
+    csr.targets.resize(csr.offsets[nodeCount]); 
+    csr.weights.assign(weighted ? csr.offsets[nodeCount] : 0, 1); 
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        auto& node = graph.nodes[i]; 
+        auto out = csr.targets.data() + csr.offsets[i]; 
+        for (auto child : node.children) {
+            *out++ = (NodeId) (child - first); 
+        }
+
+        if (weighted && !node.weights.empty()) {
+            std::copy(node.weights.begin(), node.weights.end(), csr.weights.begin() + csr.offsets[i]); 
+        }
+    }
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: TarjanScc 
+// Desc: Tarjan's algorithm without recursion (so a long path doesnt blow the stack), each frame 
+// keeps an edge cursor like the CsrGraph DepthFirstSearch. 
+// Templated on how to get at the children so it works on both Graph and CsrGraph, 
+// degree(node) is how many children node has and childAt(node, i) is the id of the i-th one.
+// Returns the component of every node and sets componentCount. Components are numbered in the 
+// order Tarjan finishes them which is reverse topological, if component a can reach 
+// component b (a != b) then a > b. 
+// O(V + E)
+//------------------------------------------------------------------------------------
+template<typename Degree, typename ChildAt>
+std::vector<uint32_t> TarjanScc(NodeId nodeCount, Degree degree, ChildAt childAt, uint32_t& componentCount) {
+    const uint32_t unvisited = 0xffffffff; 
+
+    std::vector<uint32_t> component(nodeCount, unvisited); 
+    std::vector<uint32_t> index(nodeCount, unvisited); 
+    std::vector<uint32_t> lowLink(nodeCount); 
+    std::vector<NodeId> sccStack; 
+    std::vector<std::tuple<NodeId, EdgeIndex>> callStack; // node, next child 
+    uint32_t counter = 0; 
+
+    componentCount = 0; 
+
+    // a node is on the tarjan stack if it has been visited but isnt in a component yet
+    for (NodeId root = 0; root < nodeCount; root++) {
+        if (index[root] != unvisited) { continue; }
+
+        index[root] = lowLink[root] = counter++; 
+        sccStack.push_back(root); 
+        callStack.push_back(std::tuple<NodeId, EdgeIndex>(root, 0)); 
+
+        while (!callStack.empty()) {
+            auto node = std::get<0>(callStack.back()); 
+            auto& cursor = std::get<1>(callStack.back()); 
+
+            if (cursor < degree(node)) {
+                auto child = childAt(node, cursor++); 
+
+                if (index[child] == unvisited) {
+                    index[child] = lowLink[child] = counter++; 
+                    sccStack.push_back(child); 
+                    callStack.push_back(std::tuple<NodeId, EdgeIndex>(child, 0)); 
+                } else if (component[child] == unvisited) {
+                    lowLink[node] = std::min(lowLink[node], index[child]); 
+                }
+
+                continue; 
+            }
+
+            // finished node, if it's the root of a component pop the whole component
+            if (lowLink[node] == index[node]) {
+                NodeId member; 
+                do {
+                    member = sccStack.back(); 
+                    sccStack.pop_back(); 
+                    component[member] = componentCount; 
+                } while (member != node); 
+
+                componentCount++; 
+            }
+
+            callStack.pop_back(); 
+
+            if (!callStack.empty()) {
+                auto parent = std::get<0>(callStack.back()); 
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]); 
+            }
+        }
+    }
+
+    return component; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: StronglyConnectedComponents 
+// Desc: Tarjan on a CsrGraph, see TarjanScc
+//------------------------------------------------------------------------------------
+std::vector<uint32_t> StronglyConnectedComponents(const CsrGraph& graph, uint32_t& componentCount) {
+    return TarjanScc(graph.NodeCount(), 
+        [&graph] (NodeId node) { return graph.Degree(node); }, 
+        [&graph] (NodeId node, EdgeIndex i) { return graph.ChildrenBegin(node)[i]; }, 
+        componentCount); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: StronglyConnectedComponents 
+// Desc: Tarjan on a Graph, node ids are positions in graph.nodes
+//------------------------------------------------------------------------------------
+std::vector<uint32_t> StronglyConnectedComponents(const Graph& graph, uint32_t& componentCount) {
+    auto first = graph.nodes.data(); 
+
+    return TarjanScc((NodeId) graph.nodes.size(), 
+        [&graph] (NodeId node) { return (EdgeIndex) graph.nodes[node].children.size(); }, 
+        [&graph, first] (NodeId node, EdgeIndex i) { return (NodeId) (graph.nodes[node].children[i] - first); }, 
+        componentCount); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: Condense 
+// Desc: build the DAG where every strongly connected component is one node, 
+// duplicate edges between two components are merged
+//------------------------------------------------------------------------------------
+void Condense(CsrGraph& dag, const CsrGraph& graph, const std::vector<uint32_t>& component, uint32_t componentCount) {
+    std::vector<Edge> edges; 
+
+    for (NodeId node = 0; node < graph.NodeCount(); node++) {
+        for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+            if (component[node] != component[*child]) {
+                edges.push_back(Edge(component[node], component[*child])); 
+            }
+        }
+    }
+
+    FromEdgeList(dag, edges, componentCount); 
+
+    // sort each row and squash duplicates down in place
+    EdgeIndex write = 0; 
+    EdgeIndex rowStart = 0; 
+
+    for (NodeId node = 0; node < componentCount; node++) {
+        auto begin = dag.targets.begin() + rowStart; 
+        auto end = dag.targets.begin() + dag.offsets[node + 1]; 
+        std::sort(begin, end); 
+
+        rowStart = dag.offsets[node + 1]; 
+        dag.offsets[node + 1] = write + (std::unique(begin, end) - begin); 
+
+        // rows only ever move left so this never overwrites a row we havent read yet
+        std::copy(begin, begin + (dag.offsets[node + 1] - write), dag.targets.begin() + write); 
+        write = dag.offsets[node + 1]; 
+    }
+
+    dag.targets.resize(write); 
+    dag.targets.shrink_to_fit(); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: Condense 
+// Desc: Graph version, each node of the DAG is named after the nodes in its component e.g. "1,3"
+//------------------------------------------------------------------------------------
+void Condense(Graph& dag, const Graph& graph, const std::vector<uint32_t>& component, uint32_t componentCount) {
+    dag.nodes.clear(); 
+    dag.nodes.resize(componentCount); 
+
+    for (size_t i = 0; i < graph.nodes.size(); i++) {
+        auto& name = dag.nodes[component[i]].name; 
+        if (!name.empty()) { name += ","; }
+        name += graph.nodes[i].name; 
+    }
+
+    auto first = graph.nodes.data(); 
+
+    for (size_t i = 0; i < graph.nodes.size(); i++) {
+        auto& children = dag.nodes[component[i]].children; 
+
+        for (auto child : graph.nodes[i].children) {
+            auto childNode = &dag.nodes[component[child - first]]; 
+
+            if (component[child - first] != component[i] && std::find(children.begin(), children.end(), childNode) == children.end()) {
+                children.push_back(childNode); 
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// ParallelFor
+// split [0, count) into threadCount contiguous ranges and call f(begin, end, threadIndex) on each 
+// from its own thread, returns when they're all done
+//------------------------------------------------------------------------------------
+template<typename F>
+void ParallelFor(size_t count, unsigned int threadCount, F f) {
+    if (threadCount <= 1 || count < threadCount) {
+        f((size_t) 0, count, 0u); 
+        return; 
+    }
+
+    std::vector<std::thread> threads; 
+
+    for (unsigned int t = 0; t < threadCount; t++) {
+        auto begin = count * t / threadCount; 
+        auto end = count * (t + 1) / threadCount; 
+        threads.push_back(std::thread(f, begin, end, t)); 
+    }
+
+    for (auto& thread : threads) { thread.join(); }
+}
+
+// atomically set value to max(value, candidate)
+inline void AtomicMax(std::atomic<uint32_t>& value, uint32_t candidate) {
+    auto current = value.load(std::memory_order_relaxed); 
+    while (current < candidate && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {}
+}
+
+//------------------------------------------------------------------------------------
+// Name: ParallelReach 
+// Desc: level synchronous parallel BFS from start that only goes into nodes where allowed(node) is true, 
+// every node reached gets its byte in reached set to 1
+//------------------------------------------------------------------------------------
+template<typename Allowed>
+void ParallelReach(const CsrGraph& graph, NodeId start, unsigned int threadCount, Allowed allowed, std::vector<std::atomic<uint8_t>>& reached) {
+    std::vector<NodeId> frontier(1, start); 
+    std::vector<std::vector<NodeId>> localNext(threadCount); 
+    reached[start].store(1, std::memory_order_relaxed); 
+
+    while (!frontier.empty()) {
+        ParallelFor(frontier.size(), threadCount, [&] (size_t begin, size_t end, unsigned int t) {
+            auto& local = localNext[t]; 
+            local.clear(); 
+
+            for (auto i = begin; i < end; i++) {
+                auto node = frontier[i]; 
+                for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+                    if (!reached[*child].load(std::memory_order_relaxed) && allowed(*child) && !reached[*child].exchange(1, std::memory_order_relaxed)) {
+                        local.push_back(*child); 
+                    }
+                }
+            }
+        }); 
+
+        frontier.clear(); 
+        for (auto& local : localNext) {
+            frontier.insert(frontier.end(), local.begin(), local.end()); 
+            local.clear(); 
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: ParallelStronglyConnectedComponents 
+// Desc: roughly the Multistep algorithm (Slota, Rajamanickam, Madduri) for graphs too big to wait on Tarjan
+//   1. trim: a node with no remaining children or no remaining parents is a component on its own 
+//   2. forward-backward: the forward and backward reach from a well connected pivot intersect in 
+//      its component, on real graphs that's usually the one giant component 
+//   3. coloring for what's left: every node takes the largest id that can reach it, the nodes with 
+//      their own id are roots and a root's component is everything of its color that can reach 
+//      it backwards. Take those out and repeat until every node is assigned
+// reverse is Transpose(graph). Component ids are NOT in topological order like Tarjan's. 
+//------------------------------------------------------------------------------------
+std::vector<uint32_t> ParallelStronglyConnectedComponents(const CsrGraph& graph, const CsrGraph& reverse, unsigned int threadCount, uint32_t& componentCount) {
+    const uint32_t unassigned = 0xffffffff; 
+    auto nodeCount = graph.NodeCount(); 
+
+    std::vector<std::atomic<uint32_t>> component(nodeCount); 
+    std::vector<std::atomic<uint32_t>> colors(nodeCount); 
+    std::atomic<uint32_t> nextComponent(0); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) { component[i].store(unassigned, std::memory_order_relaxed); }
+    }); 
+
+    auto remaining = [&component] (NodeId node) { return component[node].load(std::memory_order_relaxed) == unassigned; }; 
+
+    // 1. trim, a few passes is enough to get most of them, the coloring mops up the rest
+    for (int pass = 0; pass < 3; pass++) {
+        ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto node = (NodeId) begin; node < end; node++) {
+                if (!remaining(node)) { continue; }
+
+                auto hasRemaining = [&] (const CsrGraph& edges) {
+                    for (auto other = edges.ChildrenBegin(node); other != edges.ChildrenEnd(node); other++) {
+                        if (*other != node && remaining(*other)) { return true; }
+                    }
+                    return false; 
+                }; 
+
+                if (!hasRemaining(graph) || !hasRemaining(reverse)) {
+                    component[node].store(nextComponent.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed); 
+                }
+            }
+        }); 
+    }
+
+    // 2. forward-backward from the remaining node with the biggest in * out degree
+    NodeId pivot = InvalidNode; 
+    EdgeIndex best = 0; 
+    for (NodeId node = 0; node < nodeCount; node++) {
+        auto score = graph.Degree(node) * reverse.Degree(node); 
+        if (remaining(node) && (pivot == InvalidNode || score > best)) { pivot = node; best = score; }
+    }
+
+    if (pivot != InvalidNode) {
+        std::vector<std::atomic<uint8_t>> forward(nodeCount); 
+        std::vector<std::atomic<uint8_t>> backward(nodeCount); 
+
+        ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto i = begin; i < end; i++) { forward[i].store(0, std::memory_order_relaxed); backward[i].store(0, std::memory_order_relaxed); }
+        }); 
+
+        ParallelReach(graph, pivot, threadCount, remaining, forward); 
+        ParallelReach(reverse, pivot, threadCount, remaining, backward); 
+
+        auto pivotComponent = nextComponent.fetch_add(1, std::memory_order_relaxed); 
+
+        ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto i = begin; i < end; i++) {
+                if (forward[i].load(std::memory_order_relaxed) && backward[i].load(std::memory_order_relaxed)) { 
+                    component[i].store(pivotComponent, std::memory_order_relaxed); 
+                }
+            }
+        }); 
+    }
+
+    // 3. coloring
+    std::vector<NodeId> left; 
+    for (NodeId node = 0; node < nodeCount; node++) {
+        if (remaining(node)) { left.push_back(node); }
+    }
+
+    while (!left.empty()) {
+        ParallelFor(left.size(), threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto i = begin; i < end; i++) { colors[left[i]].store(left[i], std::memory_order_relaxed); }
+        }); 
+
+        // push colors forward until nothing changes
+        std::atomic<bool> changed(true); 
+        while (changed.load()) {
+            changed.store(false); 
+
+            ParallelFor(left.size(), threadCount, [&] (size_t begin, size_t end, unsigned int) {
+                bool localChanged = false; 
+
+                for (auto i = begin; i < end; i++) {
+                    auto node = left[i]; 
+                    auto color = colors[node].load(std::memory_order_relaxed); 
+
+                    for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+                        if (remaining(*child) && colors[*child].load(std::memory_order_relaxed) < color) {
+                            AtomicMax(colors[*child], color); 
+                            localChanged = true; 
+                        }
+                    }
+                }
+
+                if (localChanged) { changed.store(true); }
+            }); 
+        }
+
+        std::vector<NodeId> roots; 
+        for (auto node : left) {
+            if (colors[node].load(std::memory_order_relaxed) == node) { roots.push_back(node); }
+        }
+
+        // every root's backward search stays inside its own color so they can all run at once
+        ParallelFor(roots.size(), threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            std::vector<NodeId> stack; 
+
+            for (auto i = begin; i < end; i++) {
+                auto root = roots[i]; 
+                auto id = nextComponent.fetch_add(1, std::memory_order_relaxed); 
+
+                component[root].store(id, std::memory_order_relaxed); 
+                stack.push_back(root); 
+
+                while (!stack.empty()) {
+                    auto node = stack.back(); 
+                    stack.pop_back(); 
+
+                    for (auto parent = reverse.ChildrenBegin(node); parent != reverse.ChildrenEnd(node); parent++) {
+                        if (colors[*parent].load(std::memory_order_relaxed) == root && remaining(*parent)) {
+                            component[*parent].store(id, std::memory_order_relaxed); 
+                            stack.push_back(*parent); 
+                        }
+                    }
+                }
+            }
+        }); 
+
+        left.erase(std::remove_if(left.begin(), left.end(), [&] (NodeId node) { return !remaining(node); }), left.end()); 
+    }
+
+    componentCount = nextComponent.load(); 
+
+    std::vector<uint32_t> result(nodeCount); 
+    for (NodeId node = 0; node < nodeCount; node++) { result[node] = component[node].load(std::memory_order_relaxed); }
+
+    return result; 
+}
+
+//------------------------------------------------------------------------------------
+// ReachabilityIndex
+// For answering lots of "is there a route from a to b" queries on a graph that doesnt change. 
+//
+// First collapse every strongly connected component into one node (everything in a component can 
+// reach everything else in it) which leaves a DAG, then:
+//
+// small DAG: store the full transitive closure as one bitset per component, a query is one bit test. 
+// big DAG: too much memory for that (n^2 bits) so label every component with intervals from 
+// DFS traversals of the DAG instead:
+//   - tree interval [pre, post] from the DFS spanning forest, if b's is inside a's then b is a 
+//     descendant of a in the tree so a definitely reaches b
+//   - GRAIL interval [lowest post order of anything reachable, post], if b's is NOT inside a's 
+//     then a definitely can't reach b. Two traversals with different child orders to catch more.
+// Most queries get answered by one of those, the rest fall back to a DFS on the DAG that skips 
+// any component whose interval rules it out. 
+//------------------------------------------------------------------------------------
+const unsigned int GrailLabelCount = 2; 
+
+struct ReachabilityIndex {
+    std::vector<uint32_t> component; // node -> node in dag
+    CsrGraph dag; 
+
+    // closure mode, closureWords words per component
+    size_t closureWords = 0; 
+    std::vector<uint64_t> closure; 
+
+    // interval mode
+    std::vector<uint32_t> treePre; 
+    std::vector<uint32_t> treePost; 
+    std::vector<uint32_t> grailLow[GrailLabelCount]; 
+    std::vector<uint32_t> grailPost[GrailLabelCount]; 
+
+    SearchScratch scratch; 
+    size_t fallbackCount = 0; // number of queries that needed the DFS
+
+    bool UsesClosure() const { return !closure.empty(); }
+
+    size_t MemoryUsage() const {
+        auto bytes = component.capacity() * sizeof(uint32_t) + dag.offsets.capacity() * sizeof(EdgeIndex) + dag.targets.capacity() * sizeof(NodeId); 
+        bytes += closure.capacity() * sizeof(uint64_t) + (treePre.capacity() + treePost.capacity()) * sizeof(uint32_t); 
+        for (unsigned int k = 0; k < GrailLabelCount; k++) {
+            bytes += (grailLow[k].capacity() + grailPost[k].capacity()) * sizeof(uint32_t); 
+        }
+
+        return bytes; 
+    }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: LabelDag 
+// Desc: one DFS over the whole DAG filling pre/post numbers and GRAIL lows, roots and children 
+// are taken in reverse order if reversed is set so the second labelling is different to the first
+//------------------------------------------------------------------------------------
+void LabelDag(const CsrGraph& dag, bool reversed, std::vector<uint32_t>& pre, std::vector<uint32_t>& post, std::vector<uint32_t>& low) {
+    const uint32_t unvisited = 0xffffffff; 
+    auto nodeCount = dag.NodeCount(); 
+
+    pre.assign(nodeCount, unvisited); 
+    post.assign(nodeCount, unvisited); 
+    low.assign(nodeCount, unvisited); 
+
+    std::vector<std::tuple<NodeId, EdgeIndex>> stack; // node, how many children we've looked at
+    uint32_t preCounter = 0; 
+    uint32_t postCounter = 0; 
+
+    for (NodeId r = 0; r < nodeCount; r++) {
+        auto root = reversed ? nodeCount - 1 - r : r; 
+        if (pre[root] != unvisited) { continue; }
+
+        pre[root] = preCounter++; 
+        stack.push_back(std::tuple<NodeId, EdgeIndex>(root, 0)); 
+
+        while (!stack.empty()) {
+            auto node = std::get<0>(stack.back()); 
+            auto& visitedChildren = std::get<1>(stack.back()); 
+            auto degree = dag.Degree(node); 
+
+            if (visitedChildren < degree) {
+                auto i = reversed ? degree - 1 - visitedChildren : visitedChildren; 
+                auto child = dag.ChildrenBegin(node)[i]; 
+                visitedChildren++; 
+
+                if (pre[child] == unvisited) {
+                    pre[child] = preCounter++; 
+                    stack.push_back(std::tuple<NodeId, EdgeIndex>(child, 0)); 
+                }
+
+                continue; 
+            }
+
+            // every child is finished (its a DAG) so their lows are ready
+            post[node] = postCounter++; 
+            low[node] = post[node]; 
+
+            for (auto child = dag.ChildrenBegin(node); child != dag.ChildrenEnd(node); child++) {
+                low[node] = std::min(low[node], low[*child]); 
+            }
+
+            stack.pop_back(); 
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: BuildReachabilityIndex 
+// Desc: maxClosureComponents decides between the two modes, the closure needs 
+// maxClosureComponents^2 bits (default 16384 -> 32MB)
+//------------------------------------------------------------------------------------
+void BuildReachabilityIndex(ReachabilityIndex& index, const CsrGraph& graph, uint32_t maxClosureComponents = 1 << 14) {
+    uint32_t componentCount = 0; 
+    index.component = StronglyConnectedComponents(graph, componentCount); 
+    Condense(index.dag, graph, index.component, componentCount); 
+
+    index.closure.clear(); 
+    index.treePre.clear(); 
+    index.treePost.clear(); 
+    for (unsigned int k = 0; k < GrailLabelCount; k++) {
+        index.grailLow[k].clear(); 
+        index.grailPost[k].clear(); 
+    }
+
+    if (componentCount <= maxClosureComponents) {
+        // components are in reverse topological order so every child has a smaller id than its parent 
+        // and is finished before we get to the parent
+        index.closureWords = ((size_t) componentCount + 63) / 64; 
+        index.closure.assign(index.closureWords * componentCount, 0); 
+
+        for (NodeId c = 0; c < componentCount; c++) {
+            auto row = index.closure.data() + c * index.closureWords; 
+            row[c >> 6] |= 1ull << (c & 63); 
+
+            for (auto child = index.dag.ChildrenBegin(c); child != index.dag.ChildrenEnd(c); child++) {
+                auto childRow = index.closure.data() + (size_t) *child * index.closureWords; 
+                for (size_t w = 0; w < index.closureWords; w++) { row[w] |= childRow[w]; }
+            }
+        }
+    } else {
+        std::vector<uint32_t> unused; 
+        LabelDag(index.dag, false, index.treePre, index.treePost, index.grailLow[0]); 
+        index.grailPost[0] = index.treePost; 
+
+        for (unsigned int k = 1; k < GrailLabelCount; k++) {
+            LabelDag(index.dag, true, unused, index.grailPost[k], index.grailLow[k]); 
+        }
+    }
+}
+
+// true if GRAIL says from might reach to (false means it definitely can't)
+inline bool MightReach(const ReachabilityIndex& index, uint32_t from, uint32_t to) {
+    for (unsigned int k = 0; k < GrailLabelCount; k++) {
+        if (index.grailLow[k][to] < index.grailLow[k][from] || index.grailPost[k][to] > index.grailPost[k][from]) { return false; }
+    }
+
+    return true; 
+}
+
+// 4.1
+// Route between nodes using a ReachabilityIndex
+// O(1) for small graphs, usually O(1) for big ones with a pruned DFS on the condensed graph if the labels cant tell
+//
+bool RouteBetweenNodes(ReachabilityIndex& index, NodeId node1, NodeId node2) {
+    if (node1 >= index.component.size() || node2 >= index.component.size()) { return false; }
+
+    auto from = index.component[node1]; 
+    auto to = index.component[node2]; 
+
+    if (from == to) { return true; }
+
+    // reverse topological numbering, anything reachable from 'from' has a smaller id
+    if (from < to) { return false; }
+
+    if (index.UsesClosure()) {
+        return (index.closure[from * index.closureWords + (to >> 6)] >> (to & 63)) & 1; 
+    }
+
+    if (index.treePre[from] <= index.treePre[to] && index.treePost[to] <= index.treePost[from]) { return true; }
+    if (!MightReach(index, from, to)) { return false; }
+
+    // fallback, DFS from 'from' only going into components that might still reach 'to'
+    index.fallbackCount++; 
+
+    auto& scratch = index.scratch; 
+    scratch.Reset(index.dag.NodeCount()); 
+
+    auto stack = scratch.queue.data(); 
+    size_t top = 0; 
+
+    stack[top++] = from; 
+    scratch.visited.TestAndSet(from); 
+
+    while (top > 0) {
+        auto node = stack[--top]; 
+
+        for (auto child = index.dag.ChildrenBegin(node); child != index.dag.ChildrenEnd(node); child++) {
+            if (*child == to) { return true; }
+
+            if (*child > to && MightReach(index, *child, to) && scratch.visited.TestAndSet(*child)) {
+                stack[top++] = *child; 
+            }
+        }
+    }
+
+    return false; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: PackAdjacencyMatrix 
+// Desc: one byte per cell -> one bit per cell, each row is padded to a whole number of 64 bit 
+// words so rows start on a word boundary. Bit j of row i is bit (j % 64) of word i * wordsPerRow + j / 64
+//------------------------------------------------------------------------------------
+std::vector<uint64_t> PackAdjacencyMatrix(const uint8_t* adjacencyMatrix, uint32_t nodeCount) {
+    size_t wordsPerRow = ((size_t) nodeCount + 63) / 64; 
+    std::vector<uint64_t> bits(wordsPerRow * nodeCount, 0); 
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        for (size_t j = 0; j < nodeCount; j++) {
+            if (adjacencyMatrix[i * nodeCount + j]) {
+                bits[i * wordsPerRow + j / 64] |= 1ull << (j % 64); 
+            }
+        }
+    }
+
+    return bits; 
+}
+
+// the bits past nodeCount in the last word of each row are padding, they're masked off with this 
+// so whatever the caller left in them doesnt turn into edges to nodes that dont exist
+inline uint64_t LastWordMask(uint32_t nodeCount) {
+    return nodeCount % 64 ? (1ull << (nodeCount % 64)) - 1 : ~0ull; 
+}
+
+// number of set bits in row, with the diagonal bit and the padding ignored
+inline EdgeIndex RowDegree(const uint64_t* row, size_t wordsPerRow, uint32_t i, uint64_t lastMask) {
+    EdgeIndex degree = 0; 
+    for (size_t w = 0; w + 1 < wordsPerRow; w++) {
+        degree += __builtin_popcountll(row[w]); 
+    }
+
+    degree += __builtin_popcountll(row[wordsPerRow - 1] & lastMask); 
+    return degree - ((row[i / 64] >> (i % 64)) & 1); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: FromBitPackedAdjacencyMatrix 
+// Desc: same as FromAdjacencyMatrix but the matrix is 1 bit per cell (see PackAdjacencyMatrix) so it's 
+// 8x less memory to read and a whole word of 64 cells can be skipped at once if it's zero. 
+//
+// Two passes over the rows, the first popcounts each row to get the offsets and the second 
+// walks the set bits with count trailing zeros and writes the children straight into targets. 
+// Rows are independent so both passes are split across threads. With AVX2 four words are tested 
+// at once which helps on sparse matrices where most of a row is zero. 
+// Still O(n^2) but n^2 / 64 (or / 256) word operations instead of n^2 byte compares and branches
+//------------------------------------------------------------------------------------
+void FromBitPackedAdjacencyMatrix(CsrGraph& graph, const uint64_t* bits, const std::vector<std::string>& values, uint32_t nodeCount, unsigned int threadCount = 1) {
+    size_t wordsPerRow = ((size_t) nodeCount + 63) / 64; 
+    auto lastMask = LastWordMask(nodeCount); 
+
+    graph.offsets.assign(nodeCount + 1, 0); 
+    graph.weights.clear(); 
+    graph.names = values; 
+    graph.names.resize(nodeCount); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) {
+            graph.offsets[i + 1] = RowDegree(bits + i * wordsPerRow, wordsPerRow, (uint32_t) i, lastMask); 
+        }
+    }); 
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        graph.offsets[i + 1] += graph.offsets[i]; 
+    }
+
+    graph.targets.resize(graph.offsets[nodeCount]); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) {
+            auto row = bits + i * wordsPerRow; 
+            auto out = graph.targets.data() + graph.offsets[i]; 
+            size_t w = 0; 
+
+#ifdef __AVX2__
+            for (; w + 4 <= wordsPerRow; w += 4) {
+                auto block = _mm256_loadu_si256((const __m256i*) (row + w)); 
+                if (_mm256_testz_si256(block, block)) { continue; }
+
+                for (size_t k = w; k < w + 4; k++) {
+                    for (auto word = row[k] & (k + 1 == wordsPerRow ? lastMask : ~0ull); word; word &= word - 1) {
+                        auto j = (NodeId) (k * 64 + __builtin_ctzll(word)); 
+                        if (j != i) { *out++ = j; } // i-th node cant connect to itself
+                    }
+                }
+            }
+#endif
+
+            for (; w < wordsPerRow; w++) {
+                for (auto word = row[w] & (w + 1 == wordsPerRow ? lastMask : ~0ull); word; word &= word - 1) {
+                    auto j = (NodeId) (w * 64 + __builtin_ctzll(word)); 
+                    if (j != i) { *out++ = j; } // i-th node cant connect to itself
+                }
+            }
+        }
+    }); 
+}
+
+//------------------------------------------------------------------------------------
+// Edge list files
+// Text: one "from to" pair per line separated by spaces or tabs, lines starting with # or % are 
+// comments (same as the SNAP / Matrix Market style files). 
+// Binary: pairs of little endian uint32 with nothing else in the file. 
+//------------------------------------------------------------------------------------
+enum class EdgeListFormat { Text, Binary }; 
+
+// MappedFile
+// read only memory mapping of a whole file, unmapped when it goes out of scope
+struct MappedFile {
+    const char* data = nullptr; 
+    size_t size = 0; 
+
+    bool Open(const std::string& path) {
+        auto fd = open(path.c_str(), O_RDONLY); 
+        if (fd < 0) { return false; }
+
+        struct stat info; 
+        if (fstat(fd, &info) != 0) { close(fd); return false; }
+
+        size = (size_t) info.st_size; 
+        if (size > 0) {
+            auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); 
+            if (mapping == MAP_FAILED) { close(fd); size = 0; return false; }
+
+            // we read it front to back
+            madvise(mapping, size, MADV_SEQUENTIAL); 
+            data = (const char*) mapping; 
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        close(fd); 
+        return true; 
+    }
+
+    ~MappedFile() {
+        if (data) { munmap((void*) data, size); }
+    }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: ForEachEdge 
+// Desc: parse the edges in [begin, end) and call f(from, to) for each one. 
+// For text begin has to be the start of a line. Returns false (and stops there) if an id doesnt 
+// fit in a NodeId, a 64 bit id or a corrupt file would otherwise wrap round to some other node
+//------------------------------------------------------------------------------------
+template<typename F>
+bool ForEachEdge(const char* begin, const char* end, EdgeListFormat format, F f) {
+    if (format == EdgeListFormat::Binary) {
+        for (auto p = begin; p + 8 <= end; p += 8) {
+            uint32_t pair[2]; 
+            memcpy(pair, p, 8); 
+            f(pair[0], pair[1]); 
+        }
+
+        return true; 
+    }
+
+    auto p = begin; 
+    auto tooBig = false; 
+
+    auto skipSpaces = [&p, end] { while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) { p++; } }; 
+    auto parseNumber = [&p, end, &tooBig] (NodeId& value) {
+        if (p >= end || *p < '0' || *p > '9') { return false; }
+
+        uint64_t number = 0; 
+        while (p < end && *p >= '0' && *p <= '9') { 
+            number = number * 10 + (uint64_t) (*p++ - '0'); 
+            if (number > InvalidNode) { tooBig = true; return false; }
+        }
+
+        value = (NodeId) number; 
+        return true; 
+    }; 
+
+    while (p < end) {
+        skipSpaces(); 
+
+        NodeId from; 
+        NodeId to; 
+
+        if (p < end && *p != '#' && *p != '%' && parseNumber(from)) {
+            skipSpaces(); 
+            if (parseNumber(to)) { f(from, to); }
+        }
+
+        if (tooBig) { return false; }
+
+        // anything else on the line is ignored (weights etc.)
+        while (p < end && *p != '\n') { p++; }
+        p++; 
+    }
+
+    return true; 
+}
+
+// split [data, data + size) into count chunks that each start at the beginning of a line (or an 8 byte pair)
+std::vector<const char*> SplitEdgeList(const char* data, size_t size, EdgeListFormat format, unsigned int count) {
+    std::vector<const char*> bounds(count + 1); 
+    auto end = data + size; 
+
+    for (unsigned int i = 0; i <= count; i++) {
+        size_t offset = size * i / count; 
+
+        if (format == EdgeListFormat::Binary) {
+            offset -= offset % 8; 
+        } else if (i > 0 && i < count && offset < size) {
+            auto newline = (const char*) memchr(data + offset, '\n', size - offset); 
+            offset = newline ? (newline + 1 - data) : size; 
+        }
+
+        bounds[i] = i == count ? end : std::max(data + offset, i > 0 ? bounds[i - 1] : data); 
+    }
+
+    return bounds; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: LoadEdgeList 
+// Desc: memory map an edge list file and build a CsrGraph from it without ever holding a list of 
+// the edges in memory. The file is split into one chunk per thread and each thread parses its own 
+// chunk in every pass:
+//   1. (only if nodeCount is 0) find the largest node id 
+//   2. each thread counts the degrees of the edges in its chunk into its own array 
+//   3. offsets are the sum over the threads, and each thread's edges for a node go after the 
+//      edges of the threads before it, so every thread has its own write position for every node 
+//      and the fill pass doesnt need atomics (an atomic add on a random cache line stalls 
+//      everything behind it, it was ~8x slower than this). 
+// Children end up in the same order as the file. The per thread counts are 
+// threadCount * nodeCount * 4 bytes which is less than targets as long as the average degree is more than threadCount.
+// Self loops are dropped like FromEdgeList and names are left empty. 
+// Returns false if the file can't be read or has an id >= nodeCount (or too big for a NodeId at all)
+//------------------------------------------------------------------------------------
+bool LoadEdgeList(CsrGraph& graph, const std::string& path, EdgeListFormat format, unsigned int threadCount = 1, NodeId nodeCount = 0) {
+    MappedFile file; 
+    if (!file.Open(path)) { return false; }
+
+    // an empty file isnt mapped at all (data is null), it's just nodeCount nodes with no edges
+    if (file.size == 0) {
+        graph.offsets.assign((size_t) nodeCount + 1, 0); 
+        graph.targets.clear(); 
+        graph.weights.clear(); 
+        graph.names.clear(); 
+        return true; 
+    }
+
+    if (threadCount == 0) { threadCount = 1; }
+    auto bounds = SplitEdgeList(file.data, file.size, format, threadCount); 
+
+    // run parse(chunk begin, chunk end, thread) on every chunk, one thread each
+    auto eachChunk = [&] (std::function<void (const char*, const char*, unsigned int)> parse) {
+        ParallelFor(threadCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto t = begin; t < end; t++) { parse(bounds[t], bounds[t + 1], (unsigned int) t); }
+        }); 
+    }; 
+
+    if (nodeCount == 0) {
+        std::vector<uint64_t> maxIds(threadCount, 0); // id + 1 so 0 means no edges
+
+        eachChunk([&] (const char* begin, const char* end, unsigned int t) {
+            uint64_t maxId = 0; 
+            auto parsed = ForEachEdge(begin, end, format, [&maxId] (NodeId from, NodeId to) { maxId = std::max(maxId, (uint64_t) std::max(from, to) + 1); }); 
+            maxIds[t] = parsed ? maxId : (uint64_t) InvalidNode + 1; 
+        }); 
+
+        auto largest = *std::max_element(maxIds.begin(), maxIds.end()); 
+        if (largest > InvalidNode) { return false; }
+        nodeCount = (NodeId) largest; 
+    }
+
+    std::vector<std::vector<uint32_t>> counts(threadCount); 
+    std::vector<uint8_t> badId(threadCount, 0); 
+
+    eachChunk([&] (const char* begin, const char* end, unsigned int t) {
+        auto& local = counts[t]; 
+        local.assign(nodeCount, 0); 
+
+        auto parsed = ForEachEdge(begin, end, format, [&] (NodeId from, NodeId to) {
+            if (from >= nodeCount || to >= nodeCount) { badId[t] = 1; return; }
+            if (from != to) { local[from]++; }
+        }); 
+
+        if (!parsed) { badId[t] = 1; }
+    }); 
+
+    if (std::find(badId.begin(), badId.end(), 1) != badId.end()) { return false; }
+
+    // degree of each node, and turn the counts into each thread's start position within the node's children
+    graph.offsets.assign(nodeCount + 1, 0); 
+    graph.weights.clear(); 
+    graph.names.clear(); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto node = begin; node < end; node++) {
+            uint32_t degree = 0; 
+            for (unsigned int t = 0; t < threadCount; t++) {
+                auto count = counts[t][node]; 
+                counts[t][node] = degree; 
+                degree += count; 
+            }
+
+            graph.offsets[node + 1] = degree; 
+        }
+    }); 
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        graph.offsets[i + 1] += graph.offsets[i]; 
+    }
+
+    graph.targets.resize(graph.offsets[nodeCount]); 
+
+    eachChunk([&] (const char* begin, const char* end, unsigned int t) {
+        auto& cursor = counts[t]; 
+        auto offsets = graph.offsets.data(); 
+        auto targets = graph.targets.data(); 
+
+        ForEachEdge(begin, end, format, [&] (NodeId from, NodeId to) {
+            if (from != to) { targets[offsets[from] + cursor[from]++] = to; }
+        }); 
+    }); 
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: WriteEdgeList 
+// Desc: write edges in one of the formats LoadEdgeList reads
+//------------------------------------------------------------------------------------
+bool WriteEdgeList(const std::string& path, const std::vector<Edge>& edges, EdgeListFormat format) {
+    std::ofstream file(path, std::ios::binary); 
+    if (!file) { return false; }
+
+    if (format == EdgeListFormat::Binary) {
+        for (auto& edge : edges) {
+            uint32_t pair[2] = { std::get<0>(edge), std::get<1>(edge) }; 
+            file.write((const char*) pair, sizeof(pair)); 
+        }
+    } else {
+        file << "# from to\n"; 
+        for (auto& edge : edges) {
+            file << std::get<0>(edge) << " " << std::get<1>(edge) << "\n"; 
+        }
+    }
+
+    return (bool) file; 
+}
+
+//------------------------------------------------------------------------------------
+// DynamicGraph
+// Graph can't grow because Node::children holds pointers into graph.nodes. This one refers to 
+// nodes by id (their slot in slots) so slots can grow without breaking any edges. 
+// A NodeHandle also carries the slot's generation, a removed node's slot gets reused with the next 
+// generation so old handles to it stop being valid instead of pointing at the new node. 
+//
+// Every edge is in its source's children and its target's parents, and edgePositions remembers 
+// where so removing an edge is swap with the last one and pop instead of a search. 
+// Traversals are faster on a CsrGraph so Snapshot() packs the live nodes into one every so often.
+//------------------------------------------------------------------------------------
+struct NodeHandle {
+    NodeId id; 
+    uint32_t generation; 
+}; 
+
+struct EdgePosition {
+    uint32_t child;  // index in slots[from].children
+    uint32_t parent; // index in slots[to].parents
+}; 
+
+struct DynamicGraph {
+    struct Slot {
+        std::vector<NodeId> children; 
+        std::vector<NodeId> parents; 
+        std::string name; 
+        uint32_t generation = 0; 
+        bool alive = false; 
+    }; 
+
+    std::vector<Slot> slots; 
+    std::vector<NodeId> freeSlots; 
+    std::unordered_map<uint64_t, EdgePosition> edgePositions; 
+    NodeId nodeCount = 0; 
+
+    static uint64_t EdgeKey(NodeId from, NodeId to) { return ((uint64_t) from << 32) | to; }
+
+    bool IsValid(NodeHandle node) const { 
+        return node.id < slots.size() && slots[node.id].alive && slots[node.id].generation == node.generation; 
+    }
+
+    size_t EdgeCount() const { return edgePositions.size(); }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: AddNode 
+// Desc: O(1) amortized
+//------------------------------------------------------------------------------------
+NodeHandle AddNode(DynamicGraph& graph, const std::string& name = "") {
+    NodeId id; 
+
+    if (!graph.freeSlots.empty()) {
+        id = graph.freeSlots.back(); 
+        graph.freeSlots.pop_back(); 
+    } else {
+        id = (NodeId) graph.slots.size(); 
+        graph.slots.emplace_back(); 
+    }
+
+    auto& slot = graph.slots[id]; 
+    slot.alive = true; 
+    slot.name = name; 
+    graph.nodeCount++; 
+
+    return NodeHandle {id, slot.generation}; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: AddEdge 
+// Desc: returns false if either node isnt valid, from == to or the edge is already there. O(1) amortized
+//------------------------------------------------------------------------------------
+bool AddEdge(DynamicGraph& graph, NodeHandle from, NodeHandle to) {
+    if (!graph.IsValid(from) || !graph.IsValid(to) || from.id == to.id) { return false; }
+
+    auto& children = graph.slots[from.id].children; 
+    auto& parents = graph.slots[to.id].parents; 
+
+    auto inserted = graph.edgePositions.emplace(DynamicGraph::EdgeKey(from.id, to.id), EdgePosition {(uint32_t) children.size(), (uint32_t) parents.size()}); 
+    if (!inserted.second) { return false; }
+
+    children.push_back(to.id); 
+    parents.push_back(from.id); 
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: RemoveEdge 
+// Desc: returns false if the edge isnt there. O(1), the last child (and last parent) 
+// gets moved into the removed edge's spot so the order of children changes
+//------------------------------------------------------------------------------------
+bool RemoveEdge(DynamicGraph& graph, NodeHandle from, NodeHandle to) {
+    if (!graph.IsValid(from) || !graph.IsValid(to)) { return false; }
+
+    auto found = graph.edgePositions.find(DynamicGraph::EdgeKey(from.id, to.id)); 
+    if (found == graph.edgePositions.end()) { return false; }
+
+    auto position = found->second; 
+    graph.edgePositions.erase(found); 
+
+    auto& children = graph.slots[from.id].children; 
+    if (position.child + 1 != children.size()) {
+        auto moved = children.back(); 
+        children[position.child] = moved; 
+        graph.edgePositions[DynamicGraph::EdgeKey(from.id, moved)].child = position.child; 
+    }
+    children.pop_back(); 
+
+    auto& parents = graph.slots[to.id].parents; 
+    if (position.parent + 1 != parents.size()) {
+        auto moved = parents.back(); 
+        parents[position.parent] = moved; 
+        graph.edgePositions[DynamicGraph::EdgeKey(moved, to.id)].parent = position.parent; 
+    }
+    parents.pop_back(); 
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: RemoveNode 
+// Desc: removes the node and every edge in or out of it, O(degree). The slot is reused by a later 
+// AddNode with a new generation
+//------------------------------------------------------------------------------------
+bool RemoveNode(DynamicGraph& graph, NodeHandle node) {
+    if (!graph.IsValid(node)) { return false; }
+
+    auto& slot = graph.slots[node.id]; 
+
+    while (!slot.children.empty()) {
+        auto child = slot.children.back(); 
+        RemoveEdge(graph, node, NodeHandle {child, graph.slots[child].generation}); 
+    }
+
+    while (!slot.parents.empty()) {
+        auto parent = slot.parents.back(); 
+        RemoveEdge(graph, NodeHandle {parent, graph.slots[parent].generation}, node); 
+    }
+
+    slot.alive = false; 
+    slot.generation++; 
+    slot.name.clear(); 
+    graph.freeSlots.push_back(node.id); 
+    graph.nodeCount--; 
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: Snapshot 
+// Desc: pack the live nodes into a CsrGraph for traversals, the dead slots are skipped so 
+// ids are different. If slotOfNode isnt null it's filled with the slot id of every snapshot node
+//------------------------------------------------------------------------------------
+void Snapshot(CsrGraph& csr, const DynamicGraph& graph, std::vector<NodeId>* slotOfNode = nullptr) {
+    std::vector<NodeId> nodeOfSlot(graph.slots.size(), InvalidNode); 
+    NodeId nodeCount = 0; 
+
+    if (slotOfNode) { slotOfNode->clear(); }
+
+    for (NodeId id = 0; id < graph.slots.size(); id++) {
+        if (graph.slots[id].alive) {
+            nodeOfSlot[id] = nodeCount++; 
+            if (slotOfNode) { slotOfNode->push_back(id); }
+        }
+    }
+
+    csr.offsets.assign(nodeCount + 1, 0); 
+    csr.weights.clear(); 
+    csr.names.resize(nodeCount); 
+    csr.targets.resize(graph.EdgeCount()); 
+
+    for (NodeId id = 0; id < graph.slots.size(); id++) {
+        auto node = nodeOfSlot[id]; 
+        if (node == InvalidNode) { continue; }
+
+        auto& slot = graph.slots[id]; 
+        auto out = csr.targets.data() + csr.offsets[node]; 
+
+        for (auto child : slot.children) { *out++ = nodeOfSlot[child]; }
+
+        csr.offsets[node + 1] = csr.offsets[node] + slot.children.size(); 
+        csr.names[node] = slot.name; 
+    }
+}
+
+// Breadth First Search over a DynamicGraph 
+// same as the CsrGraph one but reads the children straight out of the slots so it can run between updates
+//
+bool BreadthFirstSearch(const DynamicGraph& graph, NodeHandle start, NodeHandle find, SearchScratch& scratch) {
+    if (!graph.IsValid(start)) { return false; }
+    if (start.id == find.id && graph.IsValid(find)) { return true; }
+
+    scratch.Reset((NodeId) graph.slots.size()); 
+
+    auto queue = scratch.queue.data(); 
+    size_t head = 0; 
+    size_t tail = 0; 
+
+    queue[tail++] = start.id; 
+    scratch.visited.TestAndSet(start.id); 
+
+    while (head < tail) {
+        for (auto child : graph.slots[queue[head++]].children) {
+            if (scratch.visited.TestAndSet(child)) {
+                if (child == find.id && graph.IsValid(find)) { return true; }
+
+                queue[tail++] = child; 
+            }
+        }
+    }
+
+    return false; 
+}
+
+//------------------------------------------------------------------------------------
+// KeyRemap
+// KeyedGraph hashes a key on every neighbour it looks at and NodeKey is only 16 bits. 
+// FromKeyedGraph gives each key a dense NodeId once (in key order) so everything else can run on a 
+// CsrGraph, this remembers the mapping both ways so results can be turned back into keys. 
+// Key can be any integer type, dense ids are NodeId so up to 4 billion nodes. 
+//------------------------------------------------------------------------------------
+template<typename Key>
+struct KeyRemap {
+    std::unordered_map<Key, NodeId> nodeOfKey; 
+    std::vector<Key> keyOfNode; 
+
+    // InvalidNode if key isnt in the graph
+    NodeId Find(Key key) const {
+        auto found = nodeOfKey.find(key); 
+        return found == nodeOfKey.end() ? InvalidNode : found->second; 
+    }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: FromKeyedGraph 
+// Desc: KeyedGraph -> CsrGraph. A child key that isnt in the map itself still gets a node (with no 
+// name and no children). Self loops are dropped like the other builders. O(V log V + E)
+//------------------------------------------------------------------------------------
+template<typename Key>
+void FromKeyedGraph(CsrGraph& csr, const KeyedGraph<Key>& keyed, KeyRemap<Key>& remap) {
+    remap.keyOfNode.clear(); 
+    remap.nodeOfKey.clear(); 
+
+    for (auto& node : keyed) {
+        remap.keyOfNode.push_back(node.first); 
+        for (auto child : std::get<1>(node.second)) {
+            if (keyed.find(child) == keyed.end()) { remap.keyOfNode.push_back(child); }
+        }
+    }
+
+    // sorted so the ids dont depend on the hash table's order
+    std::sort(remap.keyOfNode.begin(), remap.keyOfNode.end()); 
+    remap.keyOfNode.erase(std::unique(remap.keyOfNode.begin(), remap.keyOfNode.end()), remap.keyOfNode.end()); 
+
+    auto nodeCount = (NodeId) remap.keyOfNode.size(); 
+
+    remap.nodeOfKey.reserve(nodeCount); 
+    for (NodeId i = 0; i < nodeCount; i++) {
+        remap.nodeOfKey.emplace(remap.keyOfNode[i], i); 
+    }
+
+    csr.offsets.assign(nodeCount + 1, 0); 
+    csr.weights.clear(); 
+    csr.names.assign(nodeCount, ""); 
+
+    for (auto& node : keyed) {
+        auto id = remap.nodeOfKey[node.first]; 
+        csr.offsets[id + 1] = std::get<1>(node.second).size() - std::get<1>(node.second).count(node.first); 
+        csr.names[id] = std::get<0>(node.second); 
+    }
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        csr.offsets[i + 1] += csr.offsets[i]; 
+    }
+
+    csr.targets.resize(csr.offsets[nodeCount]); 
+
+    for (auto& node : keyed) {
+        auto id = remap.nodeOfKey[node.first]; 
+        auto out = csr.targets.data() + csr.offsets[id]; 
+
+        for (auto child : std::get<1>(node.second)) {
+            if (child != node.first) { *out++ = remap.nodeOfKey[child]; }
+        }
+
+        // the hash set has no useful order, sorted children read memory front to back
+        std::sort(csr.targets.data() + csr.offsets[id], out); 
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: ToKeyedGraph 
+// Desc: CsrGraph -> KeyedGraph, node i gets key remap.keyOfNode[i]. If remap is empty the node ids 
+// are used as keys (they have to fit in Key)
+//------------------------------------------------------------------------------------
+template<typename Key>
+void ToKeyedGraph(KeyedGraph<Key>& keyed, const CsrGraph& csr, const KeyRemap<Key>& remap) {
+    auto keyOf = [&](NodeId node) { return remap.keyOfNode.empty() ? (Key) node : remap.keyOfNode[node]; }; 
+
+    keyed.clear(); 
+    keyed.reserve(csr.NodeCount()); 
+
+    for (NodeId i = 0; i < csr.NodeCount(); i++) {
+        auto& node = keyed[keyOf(i)]; 
+        std::get<0>(node) = i < csr.names.size() ? csr.names[i] : ""; 
+
+        auto& children = std::get<1>(node); 
+        children.reserve(csr.Degree(i)); 
+        for (auto child = csr.ChildrenBegin(i); child != csr.ChildrenEnd(i); child++) {
+            children.insert(keyOf(*child)); 
+        }
+    }
+}
+
+// Breadth First Search over a KeyedGraph 
+// route from start to find without converting anything, a hash lookup for every node and every visited check
+//
+template<typename Key>
+bool BreadthFirstSearch(const KeyedGraph<Key>& keyed, Key start, Key find) {
+    if (keyed.find(start) == keyed.end()) { return false; }
+    if (start == find) { return true; }
+
+    std::unordered_set<Key> visited; 
+    std::deque<Key> queue; 
+
+    visited.insert(start); 
+    queue.push_back(start); 
+
+    while (!queue.empty()) {
+        auto node = keyed.find(queue.front()); 
+        queue.pop_front(); 
+
+        if (node == keyed.end()) { continue; }
+
+        for (auto child : std::get<1>(node->second)) {
+            if (visited.insert(child).second) {
+                if (child == find) { return true; }
+
+                queue.push_back(child); 
+            }
+        }
+    }
+
+    return false; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: FromEdgeList 
+// Desc: weighted version, same counting sort with the weights moved along with their targets. 
+// Returns false (and leaves graph alone) if an edge has an id >= nodeCount
+//------------------------------------------------------------------------------------
+bool FromEdgeList(CsrGraph& graph, const std::vector<WeightedEdge>& edges, NodeId nodeCount, const std::vector<std::string>& names = {}) {
+    if (!EdgesInRange(edges, nodeCount)) { return false; }
+
+    graph.offsets.assign(nodeCount + 1, 0); 
+    graph.names = names; 
+    graph.names.resize(nodeCount); 
+
+    for (auto& edge : edges) {
+        if (std::get<0>(edge) != std::get<1>(edge)) {
+            graph.offsets[std::get<0>(edge) + 1]++; 
+        }
+    }
+
+    for (NodeId i = 0; i < nodeCount; i++) {
+        graph.offsets[i + 1] += graph.offsets[i]; 
+    }
+
+    graph.targets.resize(graph.offsets[nodeCount]); 
+    graph.weights.resize(graph.offsets[nodeCount]); 
+
+    std::vector<EdgeIndex> cursor(graph.offsets.begin(), graph.offsets.end() - 1); 
+
+    for (auto& edge : edges) {
+        auto from = std::get<0>(edge); 
+        auto to = std::get<1>(edge); 
+
+        if (from != to) {
+            auto slot = cursor[from]++; 
+            graph.targets[slot] = to; 
+            graph.weights[slot] = std::get<2>(edge); 
+        }
+    }
+
+    return true; 
+}
+
+// ShortestPaths
+// result of a weighted search, like BfsTree but distances are sums of weights. parent of the source is itself
+typedef uint64_t Distance; 
+const Distance Infinity = 0xffffffffffffffffull; 
+
+struct ShortestPaths {
+    std::vector<NodeId> parents;      // InvalidNode if not reached
+    std::vector<Distance> distances;  // Infinity if not reached
+    NodeId settledCount = 0;          // how many nodes got their final distance, to compare searches 
+}; 
+
+// follow parents back from target, empty if target wasnt reached
+std::vector<NodeId> PathTo(const ShortestPaths& paths, NodeId target) {
+    std::vector<NodeId> path; 
+
+    if (target >= paths.parents.size() || paths.parents[target] == InvalidNode) { return path; }
+
+    for (auto node = target; ; node = paths.parents[node]) {
+        path.push_back(node); 
+        if (paths.parents[node] == node) { break; }
+    }
+
+    std::reverse(path.begin(), path.end()); 
+    return path; 
+}
+
+//------------------------------------------------------------------------------------
+// DaryHeap
+// Min heap of nodes keyed by distance with decrease key. Each node has Arity children instead of 2 
+// so the heap is shallower and a node's children sit next to each other in memory, pops look at 
+// more keys per level but they're all in one or two cache lines. 
+// position[node] is where node is in the heap so decrease key doesnt have to search for it. 
+//------------------------------------------------------------------------------------
+template<unsigned int Arity>
+struct DaryHeap {
+    static constexpr uint32_t NotInHeap = 0xffffffff; 
+
+    struct Entry {
+        Distance key; 
+        NodeId node; 
+    }; 
+
+    std::vector<Entry> entries; 
+    std::vector<uint32_t> position; 
+
+    explicit DaryHeap(NodeId nodeCount) : position(nodeCount, NotInHeap) {}
+
+    bool Empty() const { return entries.empty(); }
+
+    // insert node or lower its key, does nothing if key isnt lower
+    void PushOrDecrease(NodeId node, Distance key) {
+        auto index = position[node]; 
+
+        if (index == NotInHeap) {
+            index = (uint32_t) entries.size(); 
+            entries.push_back(Entry {key, node}); 
+        } else if (key < entries[index].key) {
+            entries[index].key = key; 
+        } else {
+            return; 
+        }
+
+        SiftUp(index); 
+    }
+
+    Entry Pop() {
+        auto top = entries[0]; 
+        position[top.node] = NotInHeap; 
+
+        auto last = entries.back(); 
+        entries.pop_back(); 
+
+        if (!entries.empty()) {
+            entries[0] = last; 
+            SiftDown(0); 
+        }
+
+        return top; 
+    }
+
+    void SiftUp(uint32_t index) {
+        auto entry = entries[index]; 
+
+        while (index > 0) {
+            auto parent = (index - 1) / Arity; 
+            if (entries[parent].key <= entry.key) { break; }
+
+            entries[index] = entries[parent]; 
+            position[entries[index].node] = index; 
+            index = parent; 
+        }
+
+        entries[index] = entry; 
+        position[entry.node] = index; 
+    }
+
+    void SiftDown(uint32_t index) {
+        auto entry = entries[index]; 
+        auto size = (uint32_t) entries.size(); 
+
+        while (true) {
+            auto first = index * Arity + 1; 
+            if (first >= size) { break; }
+
+            auto last = std::min(first + Arity, size); 
+            auto smallest = first; 
+            for (auto child = first + 1; child < last; child++) {
+                if (entries[child].key < entries[smallest].key) { smallest = child; }
+            }
+
+            if (entry.key <= entries[smallest].key) { break; }
+
+            entries[index] = entries[smallest]; 
+            position[entries[index].node] = index; 
+            index = smallest; 
+        }
+
+        entries[index] = entry; 
+        position[entry.node] = index; 
+    }
+}; 
+
+// for Dijkstra, A* without a heuristic
+struct ZeroHeuristic {
+    Distance operator()(NodeId) const { return 0; }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: AStar 
+// Desc: shortest paths from source, stops as soon as target is settled (pass InvalidNode to get 
+// every node). heuristic(node) has to be a lower bound on the distance from node to target that 
+// never drops by more than an edge's weight along that edge (consistent), then the first time a 
+// node comes off the heap its distance is final. The closer it is to the real distance the fewer 
+// nodes get settled, with ZeroHeuristic this is plain Dijkstra. 
+// O((V + E) log V) with a D-ary heap, weights cant be negative (they're unsigned anyway)
+//------------------------------------------------------------------------------------
+template<unsigned int Arity = 4, typename Heuristic>
+ShortestPaths AStar(const CsrGraph& graph, NodeId source, NodeId target, Heuristic heuristic) {
+    auto nodeCount = graph.NodeCount(); 
+
+    ShortestPaths paths; 
+    paths.parents.assign(nodeCount, InvalidNode); 
+    paths.distances.assign(nodeCount, Infinity); 
+
+    if (source >= nodeCount) { return paths; }
+
+    DaryHeap<Arity> heap(nodeCount); 
+    paths.distances[source] = 0; 
+    paths.parents[source] = source; 
+    heap.PushOrDecrease(source, heuristic(source)); 
+
+    while (!heap.Empty()) {
+        auto node = heap.Pop().node; 
+        paths.settledCount++; 
+
+        if (node == target) { break; }
+
+        auto distance = paths.distances[node]; 
+
+        for (auto edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+            auto child = graph.targets[edge]; 
+            auto childDistance = distance + graph.WeightAt(edge); 
+
+            if (childDistance < paths.distances[child]) {
+                paths.distances[child] = childDistance; 
+                paths.parents[child] = node; 
+                heap.PushOrDecrease(child, childDistance + heuristic(child)); 
+            }
+        }
+    }
+
+    return paths; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: Dijkstra 
+// Desc: AStar with no heuristic, target = InvalidNode means find every node's distance
+//------------------------------------------------------------------------------------
+template<unsigned int Arity = 4>
+ShortestPaths Dijkstra(const CsrGraph& graph, NodeId source, NodeId target = InvalidNode) {
+    return AStar<Arity>(graph, source, target, ZeroHeuristic()); 
+}
+
+// Dijkstra on a Graph, goes through a CsrGraph so Node::weights are used. 
+// Nothing is reached if some node's weights dont line up with its children
+ShortestPaths Dijkstra(const Graph& graph, const Node* source, const Node* target = nullptr) {
+    CsrGraph csr; 
+    if (!FromGraph(csr, graph)) { 
+        ShortestPaths paths; 
+        paths.parents.assign(graph.nodes.size(), InvalidNode); 
+        paths.distances.assign(graph.nodes.size(), Infinity); 
+        return paths; 
+    }
+
+    auto first = graph.nodes.data(); 
+    return Dijkstra(csr, (NodeId) (source - first), target ? (NodeId) (target - first) : InvalidNode); 
+}
+
+// atomically set value to min(value, candidate), true if it was lowered
+inline bool AtomicMin(std::atomic<Distance>& value, Distance candidate) {
+    auto current = value.load(std::memory_order_relaxed); 
+    while (candidate < current) {
+        if (value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) { return true; }
+    }
+
+    return false; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: DeltaStepping 
+// Desc: parallel single source shortest paths (Meyer and Sanders, the bucket handling is roughly 
+// how the GAP benchmark suite does it). Nodes are put into buckets of width delta by distance and 
+// each bucket is processed in parallel like a BFS level, relaxing an edge is an atomic min on the 
+// child's distance and whoever lowers it puts the child in its own bucket for that distance. 
+// A bucket can refill itself (edges lighter than delta) so it's processed until it stays empty, 
+// then everyone moves to the lowest bucket anyone has. 
+// Small delta is close to Dijkstra (lots of rounds, little wasted work), big delta is close to 
+// Bellman-Ford (few rounds, nodes relaxed many times), something around the average edge weight is a good start. 
+// Parents are worked out after from the final distances, with zero weight edges they can form a loop. 
+//------------------------------------------------------------------------------------
+ShortestPaths DeltaStepping(const CsrGraph& graph, NodeId source, Distance delta, unsigned int threadCount) {
+    auto nodeCount = graph.NodeCount(); 
+
+    ShortestPaths paths; 
+    paths.parents.assign(nodeCount, InvalidNode); 
+    paths.distances.assign(nodeCount, Infinity); 
+
+    if (source >= nodeCount) { return paths; }
+    if (threadCount == 0) { threadCount = 1; }
+    if (delta == 0) { delta = 1; }
+
+    const size_t chunkSize = 64; 
+    const size_t noBucket = ~(size_t) 0; 
+
+    std::vector<std::atomic<Distance>> distances(nodeCount); 
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) { distances[i].store(Infinity, std::memory_order_relaxed); }
+    }); 
+    distances[source].store(0, std::memory_order_relaxed); 
+
+    std::vector<NodeId> frontier(1, source); 
+    std::vector<std::vector<std::vector<NodeId>>> localBuckets(threadCount); 
+    std::vector<size_t> copyOffsets(threadCount + 1, 0); 
+    std::atomic<size_t> nextChunk(0); 
+    std::atomic<size_t> nextBucket(noBucket); 
+    std::atomic<NodeId> settled(0); 
+    size_t bucket = 0; 
+    ThreadBarrier barrier(threadCount); 
+
+    auto worker = [&] (unsigned int threadIndex) {
+        auto& buckets = localBuckets[threadIndex]; 
+        NodeId processed = 0; 
+
+        while (true) {
+            // relax everything in the frontier that's still in this bucket
+            while (true) {
+                auto begin = nextChunk.fetch_add(chunkSize, std::memory_order_relaxed); 
+                if (begin >= frontier.size()) { break; }
+                auto end = std::min(begin + chunkSize, frontier.size()); 
+
+                for (auto i = begin; i < end; i++) {
+                    auto node = frontier[i]; 
+                    auto distance = distances[node].load(std::memory_order_relaxed); 
+
+                    // it got a shorter distance after going in here and was done in an earlier bucket
+                    if (distance < delta * bucket) { continue; }
+                    processed++; 
+
+                    for (auto edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+                        auto child = graph.targets[edge]; 
+                        auto childDistance = distance + graph.WeightAt(edge); 
+
+                        if (AtomicMin(distances[child], childDistance)) {
+                            auto childBucket = (size_t) (childDistance / delta); 
+                            if (childBucket >= buckets.size()) { buckets.resize(childBucket + 1); }
+                            buckets[childBucket].push_back(child); 
+                        }
+                    }
+                }
+            }
+
+            // lowest bucket this thread has anything in, they're never lower than the current one
+            for (auto b = bucket; b < buckets.size(); b++) {
+                if (!buckets[b].empty()) {
+                    auto current = nextBucket.load(std::memory_order_relaxed); 
+                    while (b < current && !nextBucket.compare_exchange_weak(current, b, std::memory_order_relaxed)) {}
+                    break; 
+                }
+            }
+
+            barrier.Wait(); 
+
+            auto next = nextBucket.load(std::memory_order_relaxed); 
+
+            if (threadIndex == 0 && next != noBucket) {
+                for (unsigned int t = 0; t < threadCount; t++) {
+                    auto& other = localBuckets[t]; 
+                    copyOffsets[t + 1] = copyOffsets[t] + (next < other.size() ? other[next].size() : 0); 
+                }
+
+                frontier.resize(copyOffsets[threadCount]); 
+                nextChunk.store(0, std::memory_order_relaxed); 
+            }
+
+            barrier.Wait(); 
+
+            if (next == noBucket) { break; }
+
+            if (next < buckets.size()) {
+                std::copy(buckets[next].begin(), buckets[next].end(), frontier.begin() + copyOffsets[threadIndex]); 
+                buckets[next].clear(); 
+            }
+
+            // everyone has read nextBucket by now
+            if (threadIndex == 0) {
+                bucket = next; 
+                nextBucket.store(noBucket, std::memory_order_relaxed); 
+            }
+
+            barrier.Wait(); 
+        }
+
+        settled.fetch_add(processed, std::memory_order_relaxed); 
+    }; 
+
+    std::vector<std::thread> threads; 
+    for (unsigned int t = 1; t < threadCount; t++) {
+        threads.push_back(std::thread(worker, t)); 
+    }
+
+    worker(0); 
+
+    for (auto& thread : threads) { thread.join(); }
+
+    // settledCount here is how many times a node was processed, can be more than the node count
+    paths.settledCount = settled.load(); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) { paths.distances[i] = distances[i].load(std::memory_order_relaxed); }
+    }); 
+
+    // any parent on a shortest path will do, looking from the child's side with the transpose means 
+    // every node only writes its own parent so there's nothing to race on
+    CsrGraph reverse; 
+    Transpose(reverse, graph); 
+
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto node = (NodeId) begin; node < end; node++) {
+            auto distance = paths.distances[node]; 
+            if (distance == Infinity) { continue; }
+            if (node == source) { paths.parents[node] = node; continue; }
+
+            for (auto edge = reverse.offsets[node]; edge < reverse.offsets[node + 1]; edge++) {
+                auto parent = reverse.targets[edge]; 
+                if (paths.distances[parent] != Infinity && paths.distances[parent] + reverse.WeightAt(edge) == distance) {
+                    paths.parents[node] = parent; 
+                    break; 
+                }
+            }
+        }
+    }); 
+
+    return paths; 
+}
+
+//------------------------------------------------------------------------------------
+// Visitors
+// BreadthFirstVisit and DepthFirstVisit dont do anything with the nodes themselves, they call 
+//   Discover(node)         the first time node is reached (start included) 
+//   ExamineEdge(from, to)  for every edge looked at, before checking if to was visited
+//   Finish(node)           once all of node's edges have been looked at (post order for DFS)
+// on a visitor. Each returns false to stop the search right there. 
+// Visitors inherit DefaultVisitor and hide the ones they care about, there's nothing virtual so 
+// the calls are inlined and the empty ones disappear. 
+//------------------------------------------------------------------------------------
+struct DefaultVisitor {
+    bool Discover(NodeId) { return true; }
+    bool ExamineEdge(NodeId, NodeId) { return true; }
+    bool Finish(NodeId) { return true; }
+}; 
+
+// prints nodes as they're discovered, nameOf(node) gives the name. What BreadthFirstSearch used to print
+template<typename NameOf>
+struct PrintVisitor : DefaultVisitor {
+    NameOf nameOf; 
+    std::ostream& out; 
+
+    explicit PrintVisitor(NameOf nameOf, std::ostream& out = std::cout) : nameOf(nameOf), out(out) {}
+
+    bool Discover(NodeId node) { out << nameOf(node) << " "; return true; }
+}; 
+
+// stops once target is discovered
+struct FindVisitor : DefaultVisitor {
+    NodeId target; 
+    bool found = false; 
+
+    explicit FindVisitor(NodeId target) : target(target) {}
+
+    bool Discover(NodeId node) { found = node == target; return !found; }
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: BreadthFirstVisit 
+// Desc: BFS from start calling visitor on the way, returns parents and distances of everything 
+// reached before it finished or the visitor stopped it. 
+// degree/childAt are the same as for TarjanScc so it runs on Graph and CsrGraph
+// O(V + E)
+//------------------------------------------------------------------------------------
+template<typename Degree, typename ChildAt, typename Visitor>
+BfsTree BreadthFirstVisit(NodeId nodeCount, NodeId start, Degree degree, ChildAt childAt, Visitor& visitor) {
+    BfsTree tree; 
+    tree.parents.assign(nodeCount, InvalidNode); 
+    tree.distances.assign(nodeCount, Unreachable); 
+
+    if (start >= nodeCount) { return tree; }
+
+    std::vector<NodeId> queue(nodeCount); 
+    size_t head = 0; 
+    size_t tail = 0; 
+
+    queue[tail++] = start; 
+    tree.parents[start] = start; 
+    tree.distances[start] = 0; 
+
+    if (!visitor.Discover(start)) { return tree; }
+
+    while (head < tail) {
+        auto top = queue[head++]; 
+        auto count = degree(top); 
+
+        for (EdgeIndex i = 0; i < count; i++) {
+            auto child = childAt(top, i); 
+
+            if (!visitor.ExamineEdge(top, child)) { return tree; }
+
+            if (tree.parents[child] == InvalidNode) {
+                tree.parents[child] = top; 
+                tree.distances[child] = tree.distances[top] + 1; 
+                queue[tail++] = child; 
+
+                if (!visitor.Discover(child)) { return tree; }
+            }
+        }
+
+        if (!visitor.Finish(top)) { return tree; }
+    }
+
+    return tree; 
+}
+
+template<typename Visitor>
+BfsTree BreadthFirstVisit(const CsrGraph& graph, NodeId start, Visitor&& visitor) {
+    return BreadthFirstVisit(graph.NodeCount(), start, 
+        [&graph] (NodeId node) { return graph.Degree(node); }, 
+        [&graph] (NodeId node, EdgeIndex i) { return graph.targets[graph.offsets[node] + i]; }, 
+        visitor); 
+}
+
+// Graph version, node ids are positions in graph.nodes and a null start means nodes[0]
+template<typename Visitor>
+BfsTree BreadthFirstVisit(const Graph& graph, const Node* start, Visitor&& visitor) {
+    auto first = graph.nodes.data(); 
+    return BreadthFirstVisit((NodeId) graph.nodes.size(), start ? (NodeId) (start - first) : 0, 
+        [&graph] (NodeId node) { return (EdgeIndex) graph.nodes[node].children.size(); }, 
+        [&graph, first] (NodeId node, EdgeIndex i) { return (NodeId) (graph.nodes[node].children[i] - first); }, 
+        visitor); 
+}
+
+// Chapter 4 
+// Breadth First Search
+// O(n) memory (i think? worst case we store a pointer to each node...)
+// O(n) complexity 
+// true if find is reachable from start (a null start means nodes[0]). This used to print every node 
+// it went past, now that's just PrintVisitor and this is BreadthFirstVisit with a FindVisitor
+//
+bool BreadthFirstSearch(const Graph& graph, const Node* start = nullptr, const Node* find = nullptr) {
+    if (graph.nodes.empty()) { return false; }
+
+    auto first = graph.nodes.data(); 
+    auto contains = [&graph, first] (const Node* node) { return node >= first && node < first + graph.nodes.size(); }; 
+
+    if (start == nullptr) { start = first; }
+    if (!contains(start)) { return false; }
+
+    FindVisitor visitor(contains(find) ? (NodeId) (find - first) : InvalidNode); 
+    BreadthFirstVisit(graph, start, visitor); 
+    return visitor.found; 
+}
+
+// 4.1
+// Route between nodes
+// Given a directed graph, design and algorithm to find out whether there is a route between two nodes
+//
+bool RouteBetweenNodes(Graph& graph, const Node* node1, const Node* node2) {
+    return BreadthFirstSearch(graph, node1, node2);
+}
+
+//------------------------------------------------------------------------------------
+// Name: DepthFirstVisit 
+// Desc: DFS from start with an edge cursor per stack frame like the CsrGraph DepthFirstSearch, 
+// calling visitor on the way. Returns parents and the depth of each node in the DFS tree (in distances)
+// O(V + E)
+//------------------------------------------------------------------------------------
+template<typename Degree, typename ChildAt, typename Visitor>
+BfsTree DepthFirstVisit(NodeId nodeCount, NodeId start, Degree degree, ChildAt childAt, Visitor& visitor) {
+    BfsTree tree; 
+    tree.parents.assign(nodeCount, InvalidNode); 
+    tree.distances.assign(nodeCount, Unreachable); 
+
+    if (start >= nodeCount) { return tree; }
+
+    std::vector<std::tuple<NodeId, EdgeIndex>> stack; // node, next child 
+    stack.push_back(std::make_tuple(start, (EdgeIndex) 0)); 
+    tree.parents[start] = start; 
+    tree.distances[start] = 0; 
+
+    if (!visitor.Discover(start)) { return tree; }
+
+    while (!stack.empty()) {
+        auto& top = stack.back(); 
+        auto node = std::get<0>(top); 
+        auto& next = std::get<1>(top); 
+
+        if (next < degree(node)) {
+            auto child = childAt(node, next++); 
+
+            if (!visitor.ExamineEdge(node, child)) { return tree; }
+
+            if (tree.parents[child] == InvalidNode) {
+                tree.parents[child] = node; 
+                tree.distances[child] = tree.distances[node] + 1; 
+                stack.push_back(std::make_tuple(child, (EdgeIndex) 0)); // top is dangling after this
+
+                if (!visitor.Discover(child)) { return tree; }
+            }
+        } else {
+            stack.pop_back(); 
+
+            if (!visitor.Finish(node)) { return tree; }
+        }
+    }
+
+    return tree; 
+}
+
+template<typename Visitor>
+BfsTree DepthFirstVisit(const CsrGraph& graph, NodeId start, Visitor&& visitor) {
+    return DepthFirstVisit(graph.NodeCount(), start, 
+        [&graph] (NodeId node) { return graph.Degree(node); }, 
+        [&graph] (NodeId node, EdgeIndex i) { return graph.targets[graph.offsets[node] + i]; }, 
+        visitor); 
+}
+
+template<typename Visitor>
+BfsTree DepthFirstVisit(const Graph& graph, const Node* start, Visitor&& visitor) {
+    auto first = graph.nodes.data(); 
+    return DepthFirstVisit((NodeId) graph.nodes.size(), start ? (NodeId) (start - first) : 0, 
+        [&graph] (NodeId node) { return (EdgeIndex) graph.nodes[node].children.size(); }, 
+        [&graph, first] (NodeId node, EdgeIndex i) { return (NodeId) (graph.nodes[node].children[i] - first); }, 
+        visitor); 
+}
+
+//------------------------------------------------------------------------------------
+// DfsForest
+// DFS over the whole graph, every node not reached yet starts a new tree (in id order). 
+// discovery and finish come from the same clock so discovery[u] < discovery[v] < finish[v] < finish[u] 
+// exactly when v is under u in the forest. 
+// Every edge (u, v) gets a type when it's looked at:
+//   Tree     v hadnt been discovered, u is its parent 
+//   Back     v is still on the stack, an ancestor of u (or u itself), means there's a cycle 
+//   Forward  v is finished and was discovered after u, a descendant reached another way first 
+//   Cross    v is finished and was discovered before u, another branch or tree 
+//------------------------------------------------------------------------------------
+enum class EdgeType : uint8_t { Tree, Back, Forward, Cross }; 
+
+struct DfsForest {
+    std::vector<NodeId> parents;      // InvalidNode for the roots
+    std::vector<uint32_t> discovery; 
+    std::vector<uint32_t> finish; 
+    std::vector<EdgeType> edgeTypes;  // indexed like graph.targets, empty if not asked for
+    NodeId treeCount = 0; 
+}; 
+
+//------------------------------------------------------------------------------------
+// Name: DepthFirstForest 
+// Desc: iterative DFS with an edge cursor per frame so each edge is looked at once, O(V + E) 
+// however big the degrees are. Timestamps go up to 2V so that has to fit in 32 bits
+//------------------------------------------------------------------------------------
+DfsForest DepthFirstForest(const CsrGraph& graph, bool classifyEdges = true) {
+    const uint32_t notYet = 0xffffffff; 
+    auto nodeCount = graph.NodeCount(); 
+
+    DfsForest forest; 
+    forest.parents.assign(nodeCount, InvalidNode); 
+    forest.discovery.assign(nodeCount, notYet); 
+    forest.finish.assign(nodeCount, notYet); 
+    if (classifyEdges) { forest.edgeTypes.resize(graph.EdgeCount()); }
+
+    // discovery[] is 4 bytes a node and gets read for every edge, the bits are much more likely to be in cache 
+    std::vector<bool> visited(nodeCount, false); 
+    std::vector<std::tuple<NodeId, EdgeIndex>> stack; // node, next edge to look at 
+    uint32_t clock = 0; 
+
+    for (NodeId root = 0; root < nodeCount; root++) {
+        if (visited[root]) { continue; }
+
+        forest.treeCount++; 
+        visited[root] = true; 
+        forest.discovery[root] = clock++; 
+        stack.push_back(std::tuple<NodeId, EdgeIndex>(root, graph.offsets[root])); 
+
+        while (!stack.empty()) {
+            auto& top = stack.back(); 
+            auto node = std::get<0>(top); 
+            auto& cursor = std::get<1>(top); 
+
+            if (cursor == graph.offsets[node + 1]) {
+                forest.finish[node] = clock++; 
+                stack.pop_back(); 
+                continue; 
+            }
+
+            auto edge = cursor++; 
+            auto child = graph.targets[edge]; 
+
+            if (!visited[child]) {
+                if (classifyEdges) { forest.edgeTypes[edge] = EdgeType::Tree; }
+
+                visited[child] = true; 
+                forest.parents[child] = node; 
+                forest.discovery[child] = clock++; 
+                stack.push_back(std::tuple<NodeId, EdgeIndex>(child, graph.offsets[child])); 
+            } else if (classifyEdges) {
+                if (forest.finish[child] == notYet) {
+                    forest.edgeTypes[edge] = EdgeType::Back; 
+                } else if (forest.discovery[node] < forest.discovery[child]) {
+                    forest.edgeTypes[edge] = EdgeType::Forward; 
+                } else {
+                    forest.edgeTypes[edge] = EdgeType::Cross; 
+                }
+            }
+        }
+    }
+
+    return forest; 
+}
+
+//------------------------------------------------------------------------------------
+// DisjointSets
+// union find, every set is a tree and the root is the set's representative. 
+// Union hangs the shorter tree (by rank, an upper bound on its height) under the taller one and 
+// Find points everything on the path straight at the root, together that's almost O(1) per operation
+//------------------------------------------------------------------------------------
+struct DisjointSets {
+    std::vector<NodeId> parents; 
+    std::vector<uint8_t> ranks; // at most log2(n) so a byte is plenty
+
+    explicit DisjointSets(NodeId count) : parents(count), ranks(count, 0) {
+        std::iota(parents.begin(), parents.end(), 0); 
+    }
+
+    NodeId Find(NodeId node) {
+        auto root = node; 
+        while (parents[root] != root) { root = parents[root]; }
+
+        // second pass to point the whole path at the root
+        while (parents[node] != root) {
+            auto next = parents[node]; 
+            parents[node] = root; 
+            node = next; 
+        }
+
+        return root; 
+    }
+
+    // false if they were already in the same set
+    bool Union(NodeId a, NodeId b) {
+        a = Find(a); 
+        b = Find(b); 
+        if (a == b) { return false; }
+
+        if (ranks[a] < ranks[b]) { std::swap(a, b); }
+        parents[b] = a; 
+        if (ranks[a] == ranks[b]) { ranks[a]++; }
+
+        return true; 
+    }
+}; 
+
+// turn representatives into component ids 0 .. componentCount - 1, numbered in order of the lowest node in each
+template<typename RepresentativeOf>
+std::vector<uint32_t> NumberComponents(NodeId nodeCount, RepresentativeOf representativeOf, uint32_t& componentCount) {
+    const uint32_t unnumbered = 0xffffffff; 
+
+    std::vector<uint32_t> component(nodeCount); 
+    std::vector<uint32_t> numberOf(nodeCount, unnumbered); 
+    componentCount = 0; 
+
+    for (NodeId node = 0; node < nodeCount; node++) {
+        auto& number = numberOf[representativeOf(node)]; 
+        if (number == unnumbered) { number = componentCount++; }
+        component[node] = number; 
+    }
+
+    return component; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: WeaklyConnectedComponents 
+// Desc: components ignoring edge direction, union every edge then read off the sets. 
+// Same degree/childAt accessors as TarjanScc. O(E α(V))
+//------------------------------------------------------------------------------------
+template<typename Degree, typename ChildAt>
+std::vector<uint32_t> WeaklyConnectedComponents(NodeId nodeCount, Degree degree, ChildAt childAt, uint32_t& componentCount) {
+    DisjointSets sets(nodeCount); 
+
+    for (NodeId node = 0; node < nodeCount; node++) {
+        auto count = degree(node); 
+        for (EdgeIndex i = 0; i < count; i++) {
+            sets.Union(node, childAt(node, i)); 
+        }
+    }
+
+    return NumberComponents(nodeCount, [&sets] (NodeId node) { return sets.Find(node); }, componentCount); 
+}
+
+std::vector<uint32_t> WeaklyConnectedComponents(const CsrGraph& graph, uint32_t& componentCount) {
+    return WeaklyConnectedComponents(graph.NodeCount(), 
+        [&graph] (NodeId node) { return graph.Degree(node); }, 
+        [&graph] (NodeId node, EdgeIndex i) { return graph.targets[graph.offsets[node] + i]; }, 
+        componentCount); 
+}
+
+std::vector<uint32_t> WeaklyConnectedComponents(const Graph& graph, uint32_t& componentCount) {
+    auto first = graph.nodes.data(); 
+    return WeaklyConnectedComponents((NodeId) graph.nodes.size(), 
+        [&graph] (NodeId node) { return (EdgeIndex) graph.nodes[node].children.size(); }, 
+        [&graph, first] (NodeId node, EdgeIndex i) { return (NodeId) (graph.nodes[node].children[i] - first); }, 
+        componentCount); 
+}
+
+// Afforest's link, hook the larger of the two roots under the smaller with compare and swap. 
+// If someone else changed it first go up and try again, roots only ever point lower so it ends
+inline void LinkComponents(NodeId a, NodeId b, std::vector<std::atomic<NodeId>>& parents) {
+    auto rootA = parents[a].load(std::memory_order_relaxed); 
+    auto rootB = parents[b].load(std::memory_order_relaxed); 
+
+    while (rootA != rootB) {
+        auto high = std::max(rootA, rootB); 
+        auto low = std::min(rootA, rootB); 
+        auto parentOfHigh = parents[high].load(std::memory_order_relaxed); 
+
+        if (parentOfHigh == low) { break; }
+
+        if (parentOfHigh == high) {
+            auto expected = high; 
+            if (parents[high].compare_exchange_strong(expected, low, std::memory_order_relaxed)) { break; }
+        }
+
+        rootA = parents[parents[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed); 
+        rootB = parents[low].load(std::memory_order_relaxed); 
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: ParallelWeaklyConnectedComponents 
+// Desc: Afforest (Sutton, Ben-Nun, Barak), lock free union find in parallel: 
+//   1. link every node with its first couple of children and flatten the trees, on most graphs 
+//      that already puts the bulk of the nodes into one big component 
+//   2. guess the big component by sampling nodes 
+//   3. link the rest of the edges but skip the nodes already in the big component, that's most of the work gone 
+// Skipping is only right if every edge gets looked at from some end so for a directed graph the 
+// nodes outside the big component also link their parents, reverse is Transpose(graph). 
+//------------------------------------------------------------------------------------
+std::vector<uint32_t> ParallelWeaklyConnectedComponents(const CsrGraph& graph, const CsrGraph& reverse, unsigned int threadCount, uint32_t& componentCount) {
+    const EdgeIndex neighbourRounds = 2; 
+    auto nodeCount = graph.NodeCount(); 
+
+    std::vector<std::atomic<NodeId>> parents(nodeCount); 
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto i = begin; i < end; i++) { parents[i].store((NodeId) i, std::memory_order_relaxed); }
+    }); 
+
+    auto compress = [&] {
+        ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto i = begin; i < end; i++) {
+                auto parent = parents[i].load(std::memory_order_relaxed); 
+                auto grandParent = parents[parent].load(std::memory_order_relaxed); 
+
+                while (parent != grandParent) {
+                    parents[i].store(grandParent, std::memory_order_relaxed); 
+                    parent = grandParent; 
+                    grandParent = parents[parent].load(std::memory_order_relaxed); 
+                }
+            }
+        }); 
+    }; 
+
+    // 1. 
+    for (EdgeIndex round = 0; round < neighbourRounds; round++) {
+        ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+            for (auto node = (NodeId) begin; node < end; node++) {
+                if (round < graph.Degree(node)) {
+                    LinkComponents(node, graph.targets[graph.offsets[node] + round], parents); 
+                }
+            }
+        }); 
+
+        compress(); 
+    }
+
+    // 2. 
+    NodeId biggest = 0; 
+    if (nodeCount > 0) {
+        std::mt19937 rng(1234); 
+        std::unordered_map<NodeId, uint32_t> counts; 
+        uint32_t most = 0; 
+
+        for (int sample = 0; sample < 1024; sample++) {
+            auto root = parents[rng() % nodeCount].load(std::memory_order_relaxed); 
+            auto count = ++counts[root]; 
+
+            if (count > most) { 
+                most = count; 
+                biggest = root; 
+            }
+        }
+    }
+
+    // 3. 
+    ParallelFor(nodeCount, threadCount, [&] (size_t begin, size_t end, unsigned int) {
+        for (auto node = (NodeId) begin; node < end; node++) {
+            if (parents[node].load(std::memory_order_relaxed) == biggest) { continue; }
+
+            for (auto edge = graph.offsets[node] + neighbourRounds; edge < graph.offsets[node + 1]; edge++) {
+                LinkComponents(node, graph.targets[edge], parents); 
+            }
+
+            for (auto edge = reverse.offsets[node]; edge < reverse.offsets[node + 1]; edge++) {
+                LinkComponents(node, reverse.targets[edge], parents); 
+            }
+        }
+    }); 
+
+    compress(); 
+
+    return NumberComponents(nodeCount, [&parents] (NodeId node) { return parents[node].load(std::memory_order_relaxed); }, componentCount); 
+}
+
+//------------------------------------------------------------------------------------
+// Reordering
+// Traversals go wherever the edges point so if neighbours have ids far apart every step is a 
+// cache miss. These work out a better order for the nodes, order[newId] = oldId, and Relabel builds 
+// the graph again in that order. reverse is Transpose(graph), the orderings treat edges as undirected. 
+//------------------------------------------------------------------------------------
+
+// newId of every old id
+std::vector<NodeId> InverseOrder(const std::vector<NodeId>& order) {
+    std::vector<NodeId> newOf(order.size()); 
+    for (NodeId i = 0; i < order.size(); i++) { newOf[order[i]] = i; }
+    return newOf; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: Relabel 
+// Desc: graph with node order[i] moved to i, names and weights go with their nodes and edges. 
+// Children are sorted by their new id so scanning them reads memory in order
+//------------------------------------------------------------------------------------
+void Relabel(CsrGraph& out, const CsrGraph& graph, const std::vector<NodeId>& order) {
+    auto nodeCount = graph.NodeCount(); 
+    auto newOf = InverseOrder(order); 
+    auto weighted = !graph.weights.empty(); 
+
+    out.offsets.assign(nodeCount + 1, 0); 
+    out.targets.resize(graph.EdgeCount()); 
+    out.weights.resize(weighted ? graph.EdgeCount() : 0); 
+    out.names.resize(graph.names.empty() ? 0 : nodeCount); 
+
+    std::vector<std::tuple<NodeId, Weight>> children; 
+
+    for (NodeId node = 0; node < nodeCount; node++) {
+        auto old = order[node]; 
+        out.offsets[node + 1] = out.offsets[node] + graph.Degree(old); 
+        if (!graph.names.empty()) { out.names[node] = graph.names[old]; }
+
+        children.clear(); 
+        for (auto edge = graph.offsets[old]; edge < graph.offsets[old + 1]; edge++) {
+            children.push_back(std::make_tuple(newOf[graph.targets[edge]], graph.WeightAt(edge))); 
+        }
+
+        std::sort(children.begin(), children.end()); 
+
+        for (size_t i = 0; i < children.size(); i++) {
+            out.targets[out.offsets[node] + i] = std::get<0>(children[i]); 
+            if (weighted) { out.weights[out.offsets[node] + i] = std::get<1>(children[i]); }
+        }
+    }
+}
+
+// Graph version, rebuilds the nodes in the new order and points the children at their new places
+void Relabel(Graph& out, const Graph& graph, const std::vector<NodeId>& order) {
+    auto newOf = InverseOrder(order); 
+    auto first = graph.nodes.data(); 
+
+    out.nodes.clear(); 
+    out.nodes.resize(graph.nodes.size()); 
+
+    for (NodeId node = 0; node < out.nodes.size(); node++) {
+        auto& old = graph.nodes[order[node]]; 
+        out.nodes[node].name = old.name; 
+        out.nodes[node].weights = old.weights; 
+
+        for (auto child : old.children) {
+            out.nodes[node].children.push_back(&out.nodes[newOf[child - first]]); 
+        }
+    }
+}
+
+// in + out degree
+inline EdgeIndex TotalDegree(const CsrGraph& graph, const CsrGraph& reverse, NodeId node) {
+    return graph.Degree(node) + reverse.Degree(node); 
+}
+
+// every node sorted by total degree, biggest first (stable so ties keep their id order)
+std::vector<NodeId> DegreeOrder(const CsrGraph& graph, const CsrGraph& reverse) {
+    std::vector<NodeId> order(graph.NodeCount()); 
+    std::iota(order.begin(), order.end(), 0); 
+
+    std::stable_sort(order.begin(), order.end(), [&] (NodeId a, NodeId b) { 
+        return TotalDegree(graph, reverse, a) > TotalDegree(graph, reverse, b); 
+    }); 
+
+    return order; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BfsOrder 
+// Desc: nodes in the order a BFS finds them, children and parents both count as neighbours. 
+// Each component starts from its highest degree node, so the hubs and their neighbours end up 
+// close together at the front. O(V log V + E)
+//------------------------------------------------------------------------------------
+std::vector<NodeId> BfsOrder(const CsrGraph& graph, const CsrGraph& reverse) {
+    auto nodeCount = graph.NodeCount(); 
+    std::vector<NodeId> order; 
+    std::vector<bool> visited(nodeCount, false); 
+    order.reserve(nodeCount); 
+
+    for (auto root : DegreeOrder(graph, reverse)) {
+        if (visited[root]) { continue; }
+
+        visited[root] = true; 
+        auto head = order.size(); 
+        order.push_back(root); 
+
+        while (head < order.size()) {
+            auto node = order[head++]; 
+
+            for (auto side : {&graph, &reverse}) {
+                for (auto next = side->ChildrenBegin(node); next != side->ChildrenEnd(node); next++) {
+                    if (!visited[*next]) {
+                        visited[*next] = true; 
+                        order.push_back(*next); 
+                    }
+                }
+            }
+        }
+    }
+
+    return order; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: ReverseCuthillMcKee 
+// Desc: BFS from a low degree node (probably on the edge of its component), adding each node's 
+// new neighbours lowest degree first, then the whole order reversed. Neighbours end up with close 
+// ids, it's meant for meshes and road networks where it keeps every edge within a narrow band. 
+// O(V log V + E log E)
+//------------------------------------------------------------------------------------
+std::vector<NodeId> ReverseCuthillMcKee(const CsrGraph& graph, const CsrGraph& reverse) {
+    auto nodeCount = graph.NodeCount(); 
+    std::vector<NodeId> order; 
+    std::vector<bool> visited(nodeCount, false); 
+    std::vector<NodeId> found; 
+    order.reserve(nodeCount); 
+
+    auto byDegree = DegreeOrder(graph, reverse); 
+    auto lowerDegree = [&] (NodeId a, NodeId b) { return TotalDegree(graph, reverse, a) < TotalDegree(graph, reverse, b); }; 
+
+    for (auto root = byDegree.rbegin(); root != byDegree.rend(); root++) {
+        if (visited[*root]) { continue; }
+
+        visited[*root] = true; 
+        auto head = order.size(); 
+        order.push_back(*root); 
+
+        while (head < order.size()) {
+            auto node = order[head++]; 
+            found.clear(); 
+
+            for (auto side : {&graph, &reverse}) {
+                for (auto next = side->ChildrenBegin(node); next != side->ChildrenEnd(node); next++) {
+                    if (!visited[*next]) {
+                        visited[*next] = true; 
+                        found.push_back(*next); 
+                    }
+                }
+            }
+
+            std::stable_sort(found.begin(), found.end(), lowerDegree); 
+            order.insert(order.end(), found.begin(), found.end()); 
+        }
+    }
+
+    std::reverse(order.begin(), order.end()); 
+    return order; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: GorderOrder 
+// Desc: greedy ordering in the style of Gorder (Wei, Yu, Lu, Lin). The next node is the one with 
+// the best score against the last window nodes placed, a node scores a point for every edge to one 
+// of them and for every parent it shares with one of them (siblings get read together). 
+// Scores go up by one when a node enters the window and down by one when it leaves so like Gorder's 
+// unit heap the unplaced nodes sit in a linked list per score (prev/next), moving one is O(1) and 
+// the best is the first node in the highest list that isnt empty. 
+// Parents with more than maxSiblingDegree children are skipped for the sibling scores, a hub would 
+// touch most of the graph every time. Still much slower than the others
+//------------------------------------------------------------------------------------
+std::vector<NodeId> GorderOrder(const CsrGraph& graph, const CsrGraph& reverse, unsigned int window = 5, EdgeIndex maxSiblingDegree = 16) {
+    auto nodeCount = graph.NodeCount(); 
+    std::vector<NodeId> order; 
+    std::vector<uint32_t> score(nodeCount, 0); 
+    std::vector<bool> placed(nodeCount, false); 
+    std::vector<NodeId> prev(nodeCount, InvalidNode); 
+    std::vector<NodeId> next(nodeCount, InvalidNode); 
+    std::vector<NodeId> heads(1, InvalidNode);  // first node with each score, nodes scoring 0 arent in a list
+    uint32_t best = 0; 
+    order.reserve(nodeCount); 
+
+    auto unlink = [&] (NodeId node) {
+        if (prev[node] != InvalidNode) { next[prev[node]] = next[node]; } else { heads[score[node]] = next[node]; }
+        if (next[node] != InvalidNode) { prev[next[node]] = prev[node]; }
+    }; 
+
+    auto link = [&] (NodeId node) {
+        auto s = score[node]; 
+        if (s >= heads.size()) { heads.resize(s + 1, InvalidNode); }
+
+        prev[node] = InvalidNode; 
+        next[node] = heads[s]; 
+        if (heads[s] != InvalidNode) { prev[heads[s]] = node; }
+        heads[s] = node; 
+        best = std::max(best, s); 
+    }; 
+
+    auto adjust = [&] (NodeId node, int32_t delta) {
+        if (placed[node]) { return; }
+
+        if (score[node] > 0) { unlink(node); }
+        score[node] += delta; 
+        if (score[node] > 0) { link(node); }
+    }; 
+
+    auto touch = [&] (NodeId node, int32_t delta) {
+        for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) { adjust(*child, delta); }
+
+        for (auto parent = reverse.ChildrenBegin(node); parent != reverse.ChildrenEnd(node); parent++) {
+            adjust(*parent, delta); 
+
+            if (graph.Degree(*parent) <= maxSiblingDegree) {
+                for (auto sibling = graph.ChildrenBegin(*parent); sibling != graph.ChildrenEnd(*parent); sibling++) {
+                    if (*sibling != node) { adjust(*sibling, delta); }
+                }
+            }
+        }
+    }; 
+
+    // when nothing scores take the next highest degree node that's left
+    auto byDegree = DegreeOrder(graph, reverse); 
+    size_t nextByDegree = 0; 
+
+    while (order.size() < nodeCount) {
+        auto node = InvalidNode; 
+
+        while (best > 0 && heads[best] == InvalidNode) { best--; }
+
+        if (best > 0) {
+            node = heads[best]; 
+            unlink(node); 
+        }
+
+        while (node == InvalidNode) {
+            if (!placed[byDegree[nextByDegree]]) { node = byDegree[nextByDegree]; }
+            nextByDegree++; 
+        }
+
+        placed[node] = true; 
+        order.push_back(node); 
+        touch(node, 1); 
+
+        if (order.size() > window) {
+            touch(order[order.size() - 1 - window], -1); 
+        }
+    }
+
+    return order; 
+}
+
+//------------------------------------------------------------------------------------
+// Benchmarks
+//------------------------------------------------------------------------------------
+
+// time f() in milliseconds
+template<typename F> 
+double TimeMs(F f) {
+    auto start = std::chrono::high_resolution_clock::now(); 
+    f(); 
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+}
+
+// uniformly random directed edges, can contain duplicates and self loops
+std::vector<Edge> GenerateRandomEdges(NodeId nodeCount, size_t edgeCount, uint32_t seed = 1234) {
+    std::mt19937 rng(seed); 
+    std::uniform_int_distribution<NodeId> dist(0, nodeCount - 1); 
+    std::vector<Edge> edges(edgeCount); 
+
+    for (auto& edge : edges) {
+        edge = Edge(dist(rng), dist(rng)); 
+    }
+
+    return edges; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkCsrGraph
+// Desc: build the same random graph as a Graph and a CsrGraph and time the searches on both
+//------------------------------------------------------------------------------------
+void BenchmarkCsrGraph(NodeId nodeCount, size_t edgeCount) {
+    auto edges = GenerateRandomEdges(nodeCount, edgeCount); 
+
+    Graph graph; 
+    CsrGraph csr; 
+
+    auto graphBuild = TimeMs([&] { FromEdgeList(graph, edges, nodeCount); }); 
+    auto csrBuild = TimeMs([&] { FromEdgeList(csr, edges, nodeCount); }); 
+
+    auto graphBfs = TimeMs([&] { BreadthFirstSearch(graph, &graph.nodes[0]); }); 
+
+    auto csrBfs = TimeMs([&] { BreadthFirstSearch(csr, 0); }); 
+    auto csrDfs = TimeMs([&] { DepthFirstSearch(csr, 0); }); 
+
+    // unreachable target so both routes have to search everything reachable
+    auto graphRoute = TimeMs([&] { RouteBetweenNodes(graph, &graph.nodes[0], nullptr); }); 
+
+    auto csrRoute = TimeMs([&] { RouteBetweenNodes(csr, 0, InvalidNode); }); 
+
+    std::cout << "CsrGraph benchmark, " << nodeCount << " nodes " << csr.EdgeCount() << " edges\n"; 
+    std::cout << "  build: Graph " << graphBuild << " ms, CsrGraph " << csrBuild << " ms\n"; 
+    std::cout << "  BFS:   Graph " << graphBfs << " ms, CsrGraph " << csrBfs << " ms\n"; 
+    std::cout << "  route: Graph " << graphRoute << " ms, CsrGraph " << csrRoute << " ms\n"; 
+    std::cout << "  DFS:   CsrGraph " << csrDfs << " ms\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkRepeatedRoutes
+// Desc: lots of RouteBetweenNodes queries between random pairs, original version against the 
+// bitmap + flat queue versions with one SearchScratch reused for every query
+//------------------------------------------------------------------------------------
+void BenchmarkRepeatedRoutes(NodeId nodeCount, size_t edgeCount, unsigned int queryCount) {
+    auto edges = GenerateRandomEdges(nodeCount, edgeCount); 
+
+    Graph graph; 
+    CsrGraph csr; 
+    FromEdgeList(graph, edges, nodeCount); 
+    FromEdgeList(csr, edges, nodeCount); 
+
+    std::mt19937 rng(42); 
+    std::uniform_int_distribution<NodeId> dist(0, nodeCount - 1); 
+    std::vector<Edge> queries(queryCount); 
+    for (auto& query : queries) { query = Edge(dist(rng), dist(rng)); }
+
+    unsigned int originalFound = 0; 
+    unsigned int graphFound = 0; 
+    unsigned int csrFound = 0; 
+
+    auto original = TimeMs([&] {
+        for (auto& q : queries) { originalFound += RouteBetweenNodes(graph, &graph.nodes[std::get<0>(q)], &graph.nodes[std::get<1>(q)]); }
+    }); 
+
+    SearchScratch scratch; 
+
+    auto graphScratch = TimeMs([&] {
+        for (auto& q : queries) { graphFound += RouteBetweenNodes(graph, &graph.nodes[std::get<0>(q)], &graph.nodes[std::get<1>(q)], scratch); }
+    }); 
+
+    auto csrScratch = TimeMs([&] {
+        for (auto& q : queries) { csrFound += RouteBetweenNodes(csr, std::get<0>(q), std::get<1>(q), scratch); }
+    }); 
+
+    std::cout << "Repeated RouteBetweenNodes, " << nodeCount << " nodes " << csr.EdgeCount() << " edges " << queryCount << " queries\n"; 
+    std::cout << "  Graph BreadthFirstVisit:     " << original << " ms (" << originalFound << " found)\n"; 
+    std::cout << "  Graph bitmap + flat queue:   " << graphScratch << " ms (" << graphFound << " found)\n"; 
+    std::cout << "  CsrGraph bitmap + flat queue: " << csrScratch << " ms (" << csrFound << " found)\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: GenerateRmatEdges 
+// Desc: R-MAT / Kronecker edges like the Graph500 generator, 2^scale nodes and edgeFactor * 2^scale edges. 
+// Each edge picks a quadrant of the adjacency matrix scale times with probabilities a, b, c, 1-a-b-c
+// which gives a power law degree distribution and a small diameter, similar to a social network. 
+// Node ids are shuffled afterwards so the high degree nodes aren't all at the start
+//------------------------------------------------------------------------------------
+std::vector<Edge> GenerateRmatEdges(unsigned int scale, unsigned int edgeFactor, double a = 0.57, double b = 0.19, double c = 0.19, uint32_t seed = 1234) {
+    std::mt19937_64 rng(seed); 
+    std::uniform_real_distribution<double> dist(0.0, 1.0); 
+
+    NodeId nodeCount = (NodeId) 1 << scale; 
+    std::vector<Edge> edges((size_t) edgeFactor * nodeCount); 
+
+    for (auto& edge : edges) {
+        NodeId from = 0; 
+        NodeId to = 0; 
+
+        for (unsigned int bit = 0; bit < scale; bit++) {
+            auto r = dist(rng); 
+            auto right = r >= a && (r < a + b || r >= a + b + c); // quadrant b or d
+            auto down = r >= a + b;                                // quadrant c or d
+
+            from |= (NodeId) down << bit; 
+            to |= (NodeId) right << bit; 
+        }
+
+        edge = Edge(from, to); 
+    }
+
+    std::vector<NodeId> permutation(nodeCount); 
+    std::iota(permutation.begin(), permutation.end(), 0); 
+    std::shuffle(permutation.begin(), permutation.end(), rng); 
+
+    for (auto& edge : edges) {
+        edge = Edge(permutation[std::get<0>(edge)], permutation[std::get<1>(edge)]); 
+    }
+
+    return edges; 
+}
+
+// add the reverse of every edge so the graph is undirected
+void Symmetrize(std::vector<Edge>& edges) {
+    auto count = edges.size(); 
+    edges.reserve(count * 2); 
+
+    for (size_t i = 0; i < count; i++) {
+        edges.push_back(Edge(std::get<1>(edges[i]), std::get<0>(edges[i]))); 
+    }
+}
+
+// node with the most children, a good start for a BFS because it's definitely in the big component
+NodeId HighestDegreeNode(const CsrGraph& graph) {
+    NodeId best = 0; 
+    for (NodeId i = 0; i < graph.NodeCount(); i++) {
+        if (graph.Degree(i) > graph.Degree(best)) { best = i; }
+    }
+
+    return best; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkDirectionOptimizingBfs
+// Desc: undirected R-MAT graph, existing queue BFS against the direction optimizing one
+//------------------------------------------------------------------------------------
+void BenchmarkDirectionOptimizingBfs(unsigned int scale, unsigned int edgeFactor) {
+    auto edges = GenerateRmatEdges(scale, edgeFactor); 
+    Symmetrize(edges); 
+
+    CsrGraph graph; 
+    FromEdgeList(graph, edges, (NodeId) 1 << scale); 
+    edges = std::vector<Edge>(); 
+
+    auto start = HighestDegreeNode(graph); 
+
+    BfsTree topDown; 
+    BfsTree directionOptimizing; 
+
+    auto existing = TimeMs([&] { BreadthFirstSearch(graph, start); }); 
+    auto topDownTime = TimeMs([&] { topDown = TopDownBfs(graph, start); }); 
+
+    // undirected so the graph is its own transpose
+    auto directionTime = TimeMs([&] { directionOptimizing = DirectionOptimizingBfs(graph, graph, start); }); 
+
+    auto reached = std::count_if(topDown.distances.begin(), topDown.distances.end(), [] (uint32_t d) { return d != Unreachable; }); 
+
+    std::cout << "Direction optimizing BFS, R-MAT scale " << scale << " " << graph.NodeCount() << " nodes " << graph.EdgeCount() << " edges, " << reached << " reached\n"; 
+    std::cout << "  BreadthFirstSearch:     " << existing << " ms\n"; 
+    std::cout << "  TopDownBfs:             " << topDownTime << " ms\n"; 
+    std::cout << "  DirectionOptimizingBfs: " << directionTime << " ms\n"; 
+    std::cout << "  distances match: " << (topDown.distances == directionOptimizing.distances) << "\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkParallelBfs
+// Desc: undirected R-MAT graph, ParallelBfs at 1, 2, 4 ... maxThreads against TopDownBfs
+//------------------------------------------------------------------------------------
+void BenchmarkParallelBfs(unsigned int scale, unsigned int edgeFactor, unsigned int maxThreads) {
+    auto edges = GenerateRmatEdges(scale, edgeFactor); 
+    Symmetrize(edges); 
+
+    CsrGraph graph; 
+    FromEdgeList(graph, edges, (NodeId) 1 << scale); 
+    edges = std::vector<Edge>(); 
+
+    auto start = HighestDegreeNode(graph); 
+
+    BfsTree topDown; 
+    auto topDownTime = TimeMs([&] { topDown = TopDownBfs(graph, start); }); 
+
+    std::cout << "Parallel BFS, R-MAT scale " << scale << " " << graph.NodeCount() << " nodes " << graph.EdgeCount() << " edges, " 
+        << std::thread::hardware_concurrency() << " hardware threads\n"; 
+    std::cout << "  TopDownBfs:           " << topDownTime << " ms\n"; 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        std::vector<uint32_t> distances; 
+        auto time = TimeMs([&] { distances = ParallelBfs(graph, start, threads); }); 
+
+        std::cout << "  ParallelBfs " << threads << " threads: " << time << " ms, " 
+            << (graph.EdgeCount() / (time * 1000.0)) << " M edges/s, distances match: " << (distances == topDown.distances) << "\n"; 
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkBidirectionalRoutes
+// Desc: directed R-MAT graph, random pairs, forward only RouteBetweenNodes against the bidirectional one.
+// Also checks every path the bidirectional search returns is actually made of edges in the graph
+//------------------------------------------------------------------------------------
+void BenchmarkBidirectionalRoutes(unsigned int scale, unsigned int edgeFactor, unsigned int queryCount) {
+    CsrGraph graph; 
+    FromEdgeList(graph, GenerateRmatEdges(scale, edgeFactor), (NodeId) 1 << scale); 
+
+    BidirectionalRouter router; 
+    auto buildTime = TimeMs([&] { router.Build(graph); }); 
+
+    std::mt19937 rng(42); 
+    std::uniform_int_distribution<NodeId> dist(0, graph.NodeCount() - 1); 
+    std::vector<Edge> queries(queryCount); 
+    for (auto& query : queries) { query = Edge(dist(rng), dist(rng)); }
+
+    SearchScratch scratch; 
+    size_t forwardVisited = 0; 
+    size_t bidirectionalVisited = 0; 
+    unsigned int forwardFound = 0; 
+    unsigned int bidirectionalFound = 0; 
+    bool pathsValid = true; 
+
+    auto forwardTime = TimeMs([&] {
+        for (auto& q : queries) {
+            forwardFound += RouteBetweenNodes(graph, std::get<0>(q), std::get<1>(q), scratch); 
+            forwardVisited += scratch.visitedCount; 
+        }
+    }); 
+
+    std::vector<NodeId> path; 
+    auto bidirectionalTime = TimeMs([&] {
+        for (auto& q : queries) {
+            bidirectionalFound += RouteBetweenNodes(router, std::get<0>(q), std::get<1>(q), &path); 
+            bidirectionalVisited += router.visitedCount; 
+
+            for (size_t i = 0; i + 1 < path.size(); i++) {
+                pathsValid &= std::find(graph.ChildrenBegin(path[i]), graph.ChildrenEnd(path[i]), path[i + 1]) != graph.ChildrenEnd(path[i]); 
+            }
+        }
+    }); 
+
+    std::cout << "Bidirectional RouteBetweenNodes, R-MAT scale " << scale << " " << graph.NodeCount() << " nodes " << graph.EdgeCount() << " edges, " << queryCount << " queries\n"; 
+    std::cout << "  reverse graph build: " << buildTime << " ms\n"; 
+    std::cout << "  forward:       " << forwardTime << " ms, " << forwardVisited / queryCount << " nodes visited per query, " << forwardFound << " found\n"; 
+    std::cout << "  bidirectional: " << bidirectionalTime << " ms, " << bidirectionalVisited / queryCount << " nodes visited per query, " << bidirectionalFound << " found, paths valid: " << pathsValid << "\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkReachabilityIndex
+// Desc: index build time, size and query throughput against RouteBetweenNodes with a BFS per query, 
+// on a directed R-MAT graph. The answers are checked against the BFS for the first few queries.
+// maxClosureComponents is passed through so both modes can be tried
+//------------------------------------------------------------------------------------
+void BenchmarkReachabilityIndex(unsigned int scale, unsigned int edgeFactor, unsigned int queryCount, uint32_t maxClosureComponents) {
+    CsrGraph graph; 
+    FromEdgeList(graph, GenerateRmatEdges(scale, edgeFactor), (NodeId) 1 << scale); 
+
+    ReachabilityIndex index; 
+    auto buildTime = TimeMs([&] { BuildReachabilityIndex(index, graph, maxClosureComponents); }); 
+
+    std::mt19937 rng(42); 
+    std::uniform_int_distribution<NodeId> dist(0, graph.NodeCount() - 1); 
+    std::vector<Edge> queries(queryCount); 
+    for (auto& query : queries) { query = Edge(dist(rng), dist(rng)); }
+
+    unsigned int found = 0; 
+    auto queryTime = TimeMs([&] {
+        for (auto& q : queries) { found += RouteBetweenNodes(index, std::get<0>(q), std::get<1>(q)); }
+    }); 
+
+    // BFS is way slower so only do a few of them
+    auto bfsQueries = std::min(queryCount, 200u); 
+    SearchScratch scratch; 
+    bool matches = true; 
+
+    auto bfsTime = TimeMs([&] {
+        for (unsigned int i = 0; i < bfsQueries; i++) {
+            auto& q = queries[i]; 
+            matches &= RouteBetweenNodes(graph, std::get<0>(q), std::get<1>(q), scratch) == RouteBetweenNodes(index, std::get<0>(q), std::get<1>(q)); 
+        }
+    }); 
+
+    std::cout << "ReachabilityIndex, R-MAT scale " << scale << " " << graph.NodeCount() << " nodes " << graph.EdgeCount() << " edges -> " 
+        << index.dag.NodeCount() << " components " << index.dag.EdgeCount() << " dag edges, " << (index.UsesClosure() ? "closure" : "intervals") << "\n"; 
+    std::cout << "  build: " << buildTime << " ms, size: " << index.MemoryUsage() / (1024 * 1024) << " MB\n"; 
+    std::cout << "  index: " << queryCount / (queryTime / 1000.0) << " queries/s (" << found << " of " << queryCount << " reachable, " << index.fallbackCount << " needed the DFS)\n"; 
+    std::cout << "  BFS:   " << bfsQueries / (bfsTime / 1000.0) << " queries/s, answers match: " << matches << "\n"; 
+}
+
+// true if a and b split the nodes up the same way, even if the component ids are different
+bool SamePartition(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, uint32_t componentCount) {
+    if (a.size() != b.size()) { return false; }
+
+    std::vector<uint32_t> aToB(componentCount, 0xffffffff); 
+    std::vector<uint32_t> bToA(componentCount, 0xffffffff); 
+
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] >= componentCount || b[i] >= componentCount) { return false; }
+        if (aToB[a[i]] == 0xffffffff) { aToB[a[i]] = b[i]; }
+        if (bToA[b[i]] == 0xffffffff) { bToA[b[i]] = a[i]; }
+        if (aToB[a[i]] != b[i] || bToA[b[i]] != a[i]) { return false; }
+    }
+
+    return true; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkStronglyConnectedComponents
+// Desc: directed R-MAT graph, Tarjan on Graph and CsrGraph against the parallel version 
+// at 1, 2, 4 ... maxThreads 
+//------------------------------------------------------------------------------------
+void BenchmarkStronglyConnectedComponents(unsigned int scale, unsigned int edgeFactor, unsigned int maxThreads) {
+    auto edges = GenerateRmatEdges(scale, edgeFactor); 
+    auto nodeCount = (NodeId) 1 << scale; 
+
+    Graph graph; 
+    CsrGraph csr; 
+    CsrGraph reverse; 
+    FromEdgeList(graph, edges, nodeCount); 
+    FromEdgeList(csr, edges, nodeCount); 
+    Transpose(reverse, csr); 
+    edges = std::vector<Edge>(); 
+
+    uint32_t graphCount = 0; 
+    uint32_t csrCount = 0; 
+    std::vector<uint32_t> graphComponents; 
+    std::vector<uint32_t> csrComponents; 
+
+    auto graphTime = TimeMs([&] { graphComponents = StronglyConnectedComponents(graph, graphCount); }); 
+    auto csrTime = TimeMs([&] { csrComponents = StronglyConnectedComponents(csr, csrCount); }); 
+
+    CsrGraph dag; 
+    auto condenseTime = TimeMs([&] { Condense(dag, csr, csrComponents, csrCount); }); 
+
+    std::vector<uint32_t> sizes(csrCount, 0); 
+    for (auto c : csrComponents) { sizes[c]++; }
+
+    std::cout << "Strongly connected components, R-MAT scale " << scale << " " << csr.NodeCount() << " nodes " << csr.EdgeCount() << " edges, " 
+        << csrCount << " components, largest " << *std::max_element(sizes.begin(), sizes.end()) << "\n"; 
+    std::cout << "  Tarjan Graph:    " << graphTime << " ms\n"; 
+    std::cout << "  Tarjan CsrGraph: " << csrTime << " ms, condense " << condenseTime << " ms (" << dag.EdgeCount() << " dag edges)\n"; 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        uint32_t parallelCount = 0; 
+        std::vector<uint32_t> parallelComponents; 
+        auto time = TimeMs([&] { parallelComponents = ParallelStronglyConnectedComponents(csr, reverse, threads, parallelCount); }); 
+
+        std::cout << "  Parallel " << threads << " threads: " << time << " ms, same components: " 
+            << (parallelCount == csrCount && SamePartition(csrComponents, parallelComponents, csrCount)) << "\n"; 
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkBitPackedAdjacencyMatrix
+// Desc: random n x n matrix with the given edge probability, byte matrix builders against the 
+// bit packed one. Throughput is matrix cells per second (and input bytes per second)
+//------------------------------------------------------------------------------------
+void BenchmarkBitPackedAdjacencyMatrix(uint32_t nodeCount, double density, unsigned int maxThreads) {
+    std::mt19937 rng(1234); 
+    std::bernoulli_distribution edge(density); 
+
+    std::vector<uint8_t> bytes((size_t) nodeCount * nodeCount); 
+    for (auto& cell : bytes) { cell = edge(rng); }
+
+    auto bits = PackAdjacencyMatrix(bytes.data(), nodeCount); 
+    std::vector<std::string> names; 
+
+    double cells = (double) nodeCount * nodeCount; 
+    auto report = [&] (const char* name, double ms, double inputBytes) {
+        std::cout << "  " << name << ms << " ms, " << cells / (ms * 1e6) << " G cells/s, " << inputBytes / (ms * 1e6) << " GB/s\n"; 
+    }; 
+
+    Graph graph; 
+    CsrGraph byteCsr; 
+    CsrGraph bitCsr; 
+
+    auto graphTime = TimeMs([&] { FromAdjacencyMatrix(graph, bytes.data(), names, nodeCount); }); 
+    auto byteTime = TimeMs([&] { FromAdjacencyMatrix(byteCsr, bytes.data(), names, nodeCount); }); 
+
+    std::cout << "Adjacency matrix ingestion, " << nodeCount << " x " << nodeCount << ", density " << density << ", " << byteCsr.EdgeCount() << " edges" 
+#ifdef __AVX2__
+        << ", AVX2" 
+#endif
+        << "\n"; 
+
+    report("byte Graph:      ", graphTime, cells); 
+    report("byte CsrGraph:   ", byteTime, cells); 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        auto bitTime = TimeMs([&] { FromBitPackedAdjacencyMatrix(bitCsr, bits.data(), names, nodeCount, threads); }); 
+        auto label = "bits " + std::to_string(threads) + " threads:  "; 
+        report(label.c_str(), bitTime, bits.size() * 8.0); 
+    }
+
+    std::cout << "  same graph: " << (bitCsr.offsets == byteCsr.offsets && bitCsr.targets == byteCsr.targets) << "\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkLoadEdgeList
+// Desc: write an R-MAT edge list to disk as text and binary then time loading it back, 
+// reading the text with ifstream >> into a vector of edges + FromEdgeList against LoadEdgeList
+//------------------------------------------------------------------------------------
+void BenchmarkLoadEdgeList(unsigned int scale, unsigned int edgeFactor, unsigned int maxThreads, const std::string& directory = "/tmp") {
+    auto edges = GenerateRmatEdges(scale, edgeFactor); 
+    auto nodeCount = (NodeId) 1 << scale; 
+
+    auto textPath = directory + "/edges.txt"; 
+    auto binaryPath = directory + "/edges.bin"; 
+
+    if (!WriteEdgeList(textPath, edges, EdgeListFormat::Text) || !WriteEdgeList(binaryPath, edges, EdgeListFormat::Binary)) {
+        std::cout << "Error! couldn't write to " << directory << "\n"; 
+        return; 
+    }
+
+    CsrGraph expected; 
+    FromEdgeList(expected, edges, nodeCount); 
+    edges = std::vector<Edge>(); 
+
+    std::ifstream sizeCheck(textPath, std::ios::binary | std::ios::ate); 
+    double textBytes = (double) sizeCheck.tellg(); 
+
+    CsrGraph streamed; 
+    auto streamTime = TimeMs([&] {
+        std::ifstream file(textPath); 
+        std::vector<Edge> read; 
+        std::string line; 
+
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') { continue; }
+            std::istringstream stream(line); 
+            NodeId from; 
+            NodeId to; 
+            if (stream >> from >> to) { read.push_back(Edge(from, to)); }
+        }
+
+        FromEdgeList(streamed, read, nodeCount); 
+    }); 
+
+    std::cout << "Edge list loading, R-MAT scale " << scale << " " << expected.EdgeCount() << " edges, text " << (size_t) (textBytes / (1024 * 1024)) << " MB\n"; 
+    std::cout << "  ifstream + FromEdgeList:  " << streamTime << " ms, same graph: " << (streamed.targets == expected.targets) << "\n"; 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        CsrGraph text; 
+        CsrGraph binary; 
+
+        auto textTime = TimeMs([&] { LoadEdgeList(text, textPath, EdgeListFormat::Text, threads); }); 
+        auto binaryTime = TimeMs([&] { LoadEdgeList(binary, binaryPath, EdgeListFormat::Binary, threads, nodeCount); }); 
+
+        std::cout << "  LoadEdgeList " << threads << " threads: text " << textTime << " ms (" << textBytes / (textTime * 1e6) << " GB/s), binary " 
+            << binaryTime << " ms, same graph: " << (text.offsets == expected.offsets && text.targets == expected.targets && binary.targets == expected.targets) << "\n"; 
+    }
+
+    std::remove(textPath.c_str()); 
+    std::remove(binaryPath.c_str()); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkDynamicGraph
+// Desc: start from a random graph then do rounds of updates (mostly edge inserts/removes, a few nodes 
+// added and removed) followed by a batch of route queries. Queries run straight on the DynamicGraph 
+// and on a fresh snapshot, and the snapshot is compared with rebuilding a CsrGraph from an edge list 
+// (the only option with Graph/CsrGraph)
+//------------------------------------------------------------------------------------
+void BenchmarkDynamicGraph(NodeId nodeCount, size_t edgeCount, unsigned int rounds, unsigned int updatesPerRound, unsigned int queriesPerRound) {
+    DynamicGraph graph; 
+    std::vector<NodeHandle> handles; 
+    std::mt19937 rng(1234); 
+
+    auto buildTime = TimeMs([&] {
+        for (NodeId i = 0; i < nodeCount; i++) { handles.push_back(AddNode(graph)); }
+        for (auto& edge : GenerateRandomEdges(nodeCount, edgeCount)) {
+            AddEdge(graph, handles[std::get<0>(edge)], handles[std::get<1>(edge)]); 
+        }
+    }); 
+
+    auto randomHandle = [&] { return handles[rng() % handles.size()]; }; 
+
+    double updateTime = 0; 
+    double dynamicQueryTime = 0; 
+    double snapshotTime = 0; 
+    double snapshotQueryTime = 0; 
+    double rebuildTime = 0; 
+    unsigned int dynamicFound = 0; 
+    unsigned int snapshotFound = 0; 
+    SearchScratch scratch; 
+
+    for (unsigned int round = 0; round < rounds; round++) {
+        updateTime += TimeMs([&] {
+            for (unsigned int u = 0; u < updatesPerRound; u++) {
+                auto op = rng() % 100; 
+
+                if (op < 48) {
+                    AddEdge(graph, randomHandle(), randomHandle()); 
+                } else if (op < 96) {
+                    // remove one of a random node's edges
+                    auto from = randomHandle(); 
+                    auto& children = graph.slots[from.id].children; 
+                    if (graph.IsValid(from) && !children.empty()) {
+                        auto to = children[rng() % children.size()]; 
+                        RemoveEdge(graph, from, NodeHandle {to, graph.slots[to].generation}); 
+                    }
+                } else if (op < 98) {
+                    handles.push_back(AddNode(graph)); 
+                } else {
+                    auto index = rng() % handles.size(); 
+                    RemoveNode(graph, handles[index]); 
+                    handles[index] = handles.back(); 
+                    handles.pop_back(); 
+                }
+            }
+        }); 
+
+        std::vector<std::tuple<NodeHandle, NodeHandle>> queries; 
+        for (unsigned int q = 0; q < queriesPerRound; q++) { queries.push_back(std::make_tuple(randomHandle(), randomHandle())); }
+
+        dynamicQueryTime += TimeMs([&] {
+            for (auto& q : queries) { dynamicFound += BreadthFirstSearch(graph, std::get<0>(q), std::get<1>(q), scratch); }
+        }); 
+
+        CsrGraph snapshot; 
+        std::vector<NodeId> slotOfNode; 
+        snapshotTime += TimeMs([&] { Snapshot(snapshot, graph, &slotOfNode); }); 
+
+        std::vector<NodeId> nodeOfSlot(graph.slots.size(), InvalidNode); 
+        for (NodeId node = 0; node < slotOfNode.size(); node++) { nodeOfSlot[slotOfNode[node]] = node; }
+
+        snapshotQueryTime += TimeMs([&] {
+            for (auto& q : queries) { snapshotFound += RouteBetweenNodes(snapshot, nodeOfSlot[std::get<0>(q).id], nodeOfSlot[std::get<1>(q).id], scratch); }
+        }); 
+
+        // what it would cost without DynamicGraph, getting the current edges out and rebuilding
+        std::vector<Edge> edges; 
+        for (auto& position : graph.edgePositions) {
+            edges.push_back(Edge(nodeOfSlot[position.first >> 32], nodeOfSlot[position.first & 0xffffffff])); 
+        }
+
+        CsrGraph rebuilt; 
+        rebuildTime += TimeMs([&] { FromEdgeList(rebuilt, edges, (NodeId) slotOfNode.size()); }); 
+    }
+
+    auto updates = (double) rounds * updatesPerRound; 
+    auto queries = (double) rounds * queriesPerRound; 
+
+    std::cout << "DynamicGraph, " << graph.nodeCount << " nodes " << graph.EdgeCount() << " edges, " << rounds << " rounds of " 
+        << updatesPerRound << " updates + " << queriesPerRound << " queries\n"; 
+    std::cout << "  initial build: " << buildTime << " ms\n"; 
+    std::cout << "  updates: " << updates / (updateTime / 1000.0) << " per second\n"; 
+    std::cout << "  queries on DynamicGraph: " << dynamicQueryTime / queries << " ms each (" << dynamicFound << " found)\n"; 
+    std::cout << "  snapshot: " << snapshotTime / rounds << " ms, queries on snapshot: " << snapshotQueryTime / queries << " ms each (" << snapshotFound << " found)\n"; 
+    std::cout << "  rebuild CsrGraph from edge list: " << rebuildTime / rounds << " ms\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkKeyedGraph
+// Desc: a random graph with sparse 64 bit keys stored as a KeyedGraph, routes between random pairs 
+// searched on the KeyedGraph directly and on the CsrGraph from FromKeyedGraph (including the key 
+// lookups for the two ends). Also checks the conversion round trips
+//------------------------------------------------------------------------------------
+void BenchmarkKeyedGraph(NodeId nodeCount, size_t edgeCount, unsigned int queryCount) {
+    std::mt19937_64 rng(1234); 
+    std::vector<uint64_t> keys(nodeCount); 
+    for (auto& key : keys) { key = rng(); }
+
+    KeyedGraph<uint64_t> keyed; 
+    auto keyedBuild = TimeMs([&] {
+        keyed.reserve(nodeCount); 
+        for (NodeId i = 0; i < nodeCount; i++) { keyed[keys[i]]; }
+        for (auto& edge : GenerateRandomEdges(nodeCount, edgeCount)) {
+            // no self loops, FromKeyedGraph drops them and the round trip wouldnt match
+            if (std::get<0>(edge) != std::get<1>(edge)) {
+                std::get<1>(keyed[keys[std::get<0>(edge)]]).insert(keys[std::get<1>(edge)]); 
+            }
+        }
+    }); 
+
+    CsrGraph csr; 
+    KeyRemap<uint64_t> remap; 
+    auto convert = TimeMs([&] { FromKeyedGraph(csr, keyed, remap); }); 
+
+    std::vector<std::tuple<uint64_t, uint64_t>> queries; 
+    for (unsigned int q = 0; q < queryCount; q++) {
+        queries.push_back(std::make_tuple(keys[rng() % nodeCount], keys[rng() % nodeCount])); 
+    }
+
+    unsigned int keyedFound = 0; 
+    unsigned int csrFound = 0; 
+    SearchScratch scratch; 
+
+    auto keyedTime = TimeMs([&] {
+        for (auto& q : queries) { keyedFound += BreadthFirstSearch(keyed, std::get<0>(q), std::get<1>(q)); }
+    }); 
+
+    auto csrTime = TimeMs([&] {
+        for (auto& q : queries) { csrFound += RouteBetweenNodes(csr, remap.Find(std::get<0>(q)), remap.Find(std::get<1>(q)), scratch); }
+    }); 
+
+    KeyedGraph<uint64_t> back; 
+    ToKeyedGraph(back, csr, remap); 
+
+    std::cout << "KeyedGraph<uint64_t>, " << nodeCount << " nodes " << csr.EdgeCount() << " edges, " << queryCount << " routes\n"; 
+    std::cout << "  build KeyedGraph: " << keyedBuild << " ms, FromKeyedGraph: " << convert << " ms, round trip " << (back == keyed ? "matches" : "Error!") << "\n"; 
+    std::cout << "  KeyedGraph BFS: " << keyedTime / queryCount << " ms each (" << keyedFound << " found)\n"; 
+    std::cout << "  CsrGraph BFS:   " << csrTime / queryCount << " ms each (" << csrFound << " found)\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: GenerateGridEdges
+// Desc: width x height grid, every cell connected both ways to the cells next to it with random 
+// weights in [1, maxWeight]. Node id is y * width + x
+//------------------------------------------------------------------------------------
+std::vector<WeightedEdge> GenerateGridEdges(uint32_t width, uint32_t height, Weight maxWeight, uint32_t seed = 1234) {
+    std::mt19937 rng(seed); 
+    std::uniform_int_distribution<Weight> weight(1, maxWeight); 
+    std::vector<WeightedEdge> edges; 
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            auto node = y * width + x; 
+
+            if (x + 1 < width) {
+                edges.push_back(WeightedEdge(node, node + 1, weight(rng))); 
+                edges.push_back(WeightedEdge(node + 1, node, weight(rng))); 
+            }
+
+            if (y + 1 < height) {
+                edges.push_back(WeightedEdge(node, node + width, weight(rng))); 
+                edges.push_back(WeightedEdge(node + width, node, weight(rng))); 
+            }
+        }
+    }
+
+    return edges; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: GenerateRoadEdges
+// Desc: something shaped a bit like a road network: points jittered around a width x height grid 
+// (100 units apart) with roads to their grid neighbours, 10% of them missing, and every so often a 
+// highway to a node 16 cells away. A road weighs its length times a random slowdown of 1 to 1.5, 
+// highways just their length, so straight line distance (xs, ys) is a lower bound for A*. 
+//------------------------------------------------------------------------------------
+std::vector<WeightedEdge> GenerateRoadEdges(uint32_t width, uint32_t height, std::vector<double>& xs, std::vector<double>& ys, uint32_t seed = 1234) {
+    std::mt19937 rng(seed); 
+    std::uniform_real_distribution<double> unit(0.0, 1.0); 
+    std::vector<WeightedEdge> edges; 
+
+    auto nodeCount = width * height; 
+    xs.resize(nodeCount); 
+    ys.resize(nodeCount); 
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            xs[y * width + x] = x * 100.0 + unit(rng) * 60.0; 
+            ys[y * width + x] = y * 100.0 + unit(rng) * 60.0; 
+        }
+    }
+
+    auto length = [&] (NodeId a, NodeId b) { return std::sqrt((xs[a] - xs[b]) * (xs[a] - xs[b]) + (ys[a] - ys[b]) * (ys[a] - ys[b])); }; 
+
+    auto addRoad = [&] (NodeId a, NodeId b, double slowdown) {
+        auto weight = (Weight) std::ceil(length(a, b) * slowdown); 
+        edges.push_back(WeightedEdge(a, b, weight)); 
+        edges.push_back(WeightedEdge(b, a, weight)); 
+    }; 
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            auto node = y * width + x; 
+
+            if (x + 1 < width && unit(rng) >= 0.1) { addRoad(node, node + 1, 1.0 + unit(rng) * 0.5); }
+            if (y + 1 < height && unit(rng) >= 0.1) { addRoad(node, node + width, 1.0 + unit(rng) * 0.5); }
+
+            if (x + 16 < width && y + 16 < height && unit(rng) < 1.0 / 64) {
+                addRoad(node, node + 16 * width + 16, 1.0); 
+            }
+        }
+    }
+
+    return edges; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkShortestPaths
+// Desc: on a weighted graph: full Dijkstra with 2, 4 and 8 ary heaps, delta stepping with 1 to 
+// maxThreads threads (checked against Dijkstra), then point to point queries with Dijkstra stopping 
+// at the target against A* with the given heuristic(source, target, node)
+//------------------------------------------------------------------------------------
+template<typename Heuristic>
+void BenchmarkShortestPaths(const char* label, const CsrGraph& graph, Distance delta, unsigned int maxThreads, unsigned int queryCount, Heuristic heuristic) {
+    auto nodeCount = graph.NodeCount(); 
+    std::cout << label << ", " << nodeCount << " nodes " << graph.EdgeCount() << " edges\n"; 
+
+    ShortestPaths reference; 
+    auto binary = TimeMs([&] { reference = Dijkstra<2>(graph, 0); }); 
+    auto quad = TimeMs([&] { Dijkstra<4>(graph, 0); }); 
+    auto octal = TimeMs([&] { Dijkstra<8>(graph, 0); }); 
+
+    std::cout << "  Dijkstra: 2-ary " << binary << " ms, 4-ary " << quad << " ms, 8-ary " << octal << " ms\n"; 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        ShortestPaths parallel; 
+        auto time = TimeMs([&] { parallel = DeltaStepping(graph, 0, delta, threads); }); 
+
+        // every parent has to be on a shortest path
+        auto valid = parallel.distances == reference.distances; 
+        for (NodeId node = 1; valid && node < nodeCount; node++) {
+            auto parent = parallel.parents[node]; 
+            if (parent == InvalidNode) { valid = reference.distances[node] == Infinity; continue; }
+
+            auto best = Infinity; 
+            for (auto edge = graph.offsets[parent]; edge < graph.offsets[parent + 1]; edge++) {
+                if (graph.targets[edge] == node) { best = std::min(best, parallel.distances[parent] + graph.WeightAt(edge)); }
+            }
+
+            valid = best == parallel.distances[node]; 
+        }
+
+        std::cout << "  delta stepping (delta " << delta << ") " << threads << " threads: " << time << " ms, " 
+            << parallel.settledCount << " node visits, " << (valid ? "matches" : "Error!") << "\n"; 
+    }
+
+    std::mt19937 rng(1234); 
+    double dijkstraTime = 0; 
+    double aStarTime = 0; 
+    size_t dijkstraSettled = 0; 
+    size_t aStarSettled = 0; 
+    unsigned int mismatches = 0; 
+
+    for (unsigned int q = 0; q < queryCount; q++) {
+        NodeId source = rng() % nodeCount; 
+        NodeId target = rng() % nodeCount; 
+
+        ShortestPaths plain; 
+        ShortestPaths guided; 
+
+        dijkstraTime += TimeMs([&] { plain = Dijkstra(graph, source, target); }); 
+        aStarTime += TimeMs([&] { guided = AStar(graph, source, target, [&] (NodeId node) { return heuristic(node, target); }); }); 
+
+        dijkstraSettled += plain.settledCount; 
+        aStarSettled += guided.settledCount; 
+        mismatches += plain.distances[target] != guided.distances[target]; 
+    }
+
+    std::cout << "  " << queryCount << " point to point: Dijkstra " << dijkstraTime / queryCount << " ms (" << dijkstraSettled / queryCount 
+        << " settled), A* " << aStarTime / queryCount << " ms (" << aStarSettled / queryCount << " settled), " 
+        << (mismatches ? "Error!" : "same distances") << "\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkWeightedGraphs
+// Desc: BenchmarkShortestPaths on a side x side grid (manhattan distance times the smallest weight 
+// as the heuristic) and a side x side road network (straight line distance)
+//------------------------------------------------------------------------------------
+void BenchmarkWeightedGraphs(uint32_t side, unsigned int maxThreads, unsigned int queryCount) {
+    CsrGraph grid; 
+    FromEdgeList(grid, GenerateGridEdges(side, side, 100), side * side); 
+
+    BenchmarkShortestPaths("grid", grid, 100, maxThreads, queryCount, [side] (NodeId node, NodeId target) {
+        auto dx = (int64_t) (node % side) - (int64_t) (target % side); 
+        auto dy = (int64_t) (node / side) - (int64_t) (target / side); 
+        return (Distance) (std::abs(dx) + std::abs(dy)); 
+    }); 
+
+    std::vector<double> xs; 
+    std::vector<double> ys; 
+    CsrGraph roads; 
+    FromEdgeList(roads, GenerateRoadEdges(side, side, xs, ys), side * side); 
+
+    BenchmarkShortestPaths("road network", roads, 400, maxThreads, queryCount, [&] (NodeId node, NodeId target) {
+        auto dx = xs[node] - xs[target]; 
+        auto dy = ys[node] - ys[target]; 
+        return (Distance) std::sqrt(dx * dx + dy * dy); 
+    }); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkVisitors
+// Desc: a full BFS with BreadthFirstVisit and visitors that do nothing / count edges against 
+// TopDownBfs which is the same loop written out by hand, if the callbacks inline they should be the 
+// same speed. A visitor calling through std::function shows what it would cost if they didnt. 
+// Also the printing visitor (to a stream that throws the output away) against the Graph BreadthFirstSearch 
+// that only looks for a node
+//------------------------------------------------------------------------------------
+void BenchmarkVisitors(NodeId nodeCount, size_t edgeCount, unsigned int repeats) {
+    auto edges = GenerateRandomEdges(nodeCount, edgeCount); 
+
+    CsrGraph csr; 
+    Graph graph; 
+    FromEdgeList(csr, edges, nodeCount); 
+    FromEdgeList(graph, edges, nodeCount); 
+
+    struct CountVisitor : DefaultVisitor {
+        EdgeIndex edges = 0; 
+        bool ExamineEdge(NodeId, NodeId) { edges++; return true; }
+    }; 
+
+    struct FunctionVisitor {
+        std::function<bool(NodeId)> discover; 
+        std::function<bool(NodeId, NodeId)> examineEdge; 
+        std::function<bool(NodeId)> finish; 
+
+        bool Discover(NodeId node) { return discover(node); }
+        bool ExamineEdge(NodeId from, NodeId to) { return examineEdge(from, to); }
+        bool Finish(NodeId node) { return finish(node); }
+    }; 
+
+    EdgeIndex functionEdges = 0; 
+    FunctionVisitor functionVisitor; 
+    functionVisitor.discover = [] (NodeId) { return true; }; 
+    functionVisitor.examineEdge = [&functionEdges] (NodeId, NodeId) { functionEdges++; return true; }; 
+    functionVisitor.finish = [] (NodeId) { return true; }; 
+
+    BfsTree handWritten; 
+    BfsTree visited; 
+    CountVisitor counter; 
+
+    double handTime = 0; 
+    double emptyTime = 0; 
+    double countTime = 0; 
+    double functionTime = 0; 
+    double dfsTime = 0; 
+
+    for (unsigned int r = 0; r < repeats; r++) {
+        handTime += TimeMs([&] { handWritten = TopDownBfs(csr, 0); }); 
+        emptyTime += TimeMs([&] { visited = BreadthFirstVisit(csr, 0, DefaultVisitor()); }); 
+        countTime += TimeMs([&] { BreadthFirstVisit(csr, 0, counter); }); 
+        functionTime += TimeMs([&] { BreadthFirstVisit(csr, 0, functionVisitor); }); 
+        dfsTime += TimeMs([&] { DepthFirstVisit(csr, 0, DefaultVisitor()); }); 
+    }
+
+    std::ostream discard(nullptr); 
+    auto printTime = TimeMs([&] { 
+        BreadthFirstVisit(graph, &graph.nodes[0], PrintVisitor([&graph] (NodeId node) -> const std::string& { return graph.nodes[node].name; }, discard)); 
+    }); 
+
+    auto findTime = TimeMs([&] { BreadthFirstSearch(graph, &graph.nodes[0]); }); 
+
+    std::cout << "Visitors, " << nodeCount << " nodes " << csr.EdgeCount() << " edges, full BFS from 0\n"; 
+    std::cout << "  TopDownBfs (hand written): " << handTime / repeats << " ms\n"; 
+    std::cout << "  BreadthFirstVisit, DefaultVisitor: " << emptyTime / repeats << " ms, same tree: " << (visited.distances == handWritten.distances && visited.parents == handWritten.parents) << "\n"; 
+    std::cout << "  BreadthFirstVisit, counting edges: " << countTime / repeats << " ms (" << counter.edges / repeats << " edges)\n"; 
+    std::cout << "  BreadthFirstVisit, std::function:  " << functionTime / repeats << " ms (" << functionEdges / repeats << " edges)\n"; 
+    std::cout << "  DepthFirstVisit, DefaultVisitor:   " << dfsTime / repeats << " ms\n"; 
+    std::cout << "  Graph BFS with PrintVisitor: " << printTime << " ms, BreadthFirstSearch (FindVisitor): " << findTime << " ms\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkDepthFirstForest
+// Desc: DFS over a whole R-MAT graph (a few huge hubs and lots of nodes with no edges, so plenty of 
+// trees). The fixed Graph DepthFirstSearch (output off), the CsrGraph DepthFirstSearch from node 0 
+// only, and DepthFirstForest with and without edge types. Checks the parenthesis property on tree 
+// edges and that every back edge really goes to an ancestor
+//------------------------------------------------------------------------------------
+void BenchmarkDepthFirstForest(unsigned int scale, unsigned int edgeFactor) {
+    NodeId nodeCount = 1u << scale; 
+    auto edges = GenerateRmatEdges(scale, edgeFactor); 
+
+    Graph graph; 
+    CsrGraph csr; 
+    FromEdgeList(graph, edges, nodeCount); 
+    FromEdgeList(csr, edges, nodeCount); 
+
+    std::cout.setstate(std::ios::failbit); 
+    auto graphTime = TimeMs([&] { DepthFirstSearch(graph); }); 
+    std::cout.clear(); 
+
+    auto csrTime = TimeMs([&] { DepthFirstSearch(csr, 0); }); 
+
+    DfsForest forest; 
+    auto plainTime = TimeMs([&] { DepthFirstForest(csr, false); }); 
+    auto classifyTime = TimeMs([&] { forest = DepthFirstForest(csr, true); }); 
+
+    size_t counts[4] = {0, 0, 0, 0}; 
+    auto valid = true; 
+    auto isAncestor = [&forest] (NodeId u, NodeId v) { return forest.discovery[u] <= forest.discovery[v] && forest.finish[v] <= forest.finish[u]; }; 
+
+    for (NodeId node = 0; node < nodeCount; node++) {
+        for (auto edge = csr.offsets[node]; edge < csr.offsets[node + 1]; edge++) {
+            auto child = csr.targets[edge]; 
+            auto type = forest.edgeTypes[edge]; 
+            counts[(int) type]++; 
+
+            if (type == EdgeType::Tree) { valid = valid && forest.parents[child] == node && isAncestor(node, child); }
+            if (type == EdgeType::Back) { valid = valid && isAncestor(child, node); }
+            if (type == EdgeType::Forward) { valid = valid && isAncestor(node, child); } // a repeat of a tree edge is forward too
+            if (type == EdgeType::Cross) { valid = valid && !isAncestor(node, child) && !isAncestor(child, node); }
+        }
+    }
+
+    std::cout << "DepthFirstForest, R-MAT " << nodeCount << " nodes " << csr.EdgeCount() << " edges, " << forest.treeCount << " trees\n"; 
+    std::cout << "  Graph DepthFirstSearch (all nodes): " << graphTime << " ms\n"; 
+    std::cout << "  CsrGraph DepthFirstSearch (from 0): " << csrTime << " ms\n"; 
+    std::cout << "  DepthFirstForest: " << plainTime << " ms, with edge types: " << classifyTime << " ms\n"; 
+    std::cout << "  tree " << counts[0] << " back " << counts[1] << " forward " << counts[2] << " cross " << counts[3] 
+        << ", " << (valid ? "valid" : "Error!") << "\n"; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkWeaklyConnectedComponents
+// Desc: union find on Graph and CsrGraph against Afforest with 1 to maxThreads threads on a uniform 
+// random graph (one giant component and some stragglers) and an R-MAT graph (lots of isolated nodes)
+//------------------------------------------------------------------------------------
+void BenchmarkWeaklyConnectedComponents(const char* label, const std::vector<Edge>& edges, NodeId nodeCount, unsigned int maxThreads, bool withGraph) {
+    CsrGraph csr; 
+    CsrGraph reverse; 
+    FromEdgeList(csr, edges, nodeCount); 
+    Transpose(reverse, csr); 
+
+    uint32_t csrCount = 0; 
+    std::vector<uint32_t> csrComponents; 
+    auto csrTime = TimeMs([&] { csrComponents = WeaklyConnectedComponents(csr, csrCount); }); 
+
+    std::vector<uint32_t> sizes(csrCount, 0); 
+    for (auto c : csrComponents) { sizes[c]++; }
+
+    std::cout << "Weakly connected components, " << label << " " << nodeCount << " nodes " << csr.EdgeCount() << " edges, " 
+        << csrCount << " components, largest " << *std::max_element(sizes.begin(), sizes.end()) << "\n"; 
+
+    if (withGraph) {
+        Graph graph; 
+        FromEdgeList(graph, edges, nodeCount); 
+
+        uint32_t graphCount = 0; 
+        std::vector<uint32_t> graphComponents; 
+        auto graphTime = TimeMs([&] { graphComponents = WeaklyConnectedComponents(graph, graphCount); }); 
+
+        std::cout << "  union find Graph:    " << graphTime << " ms, same components: " << (graphComponents == csrComponents) << "\n"; 
+    }
+
+    std::cout << "  union find CsrGraph: " << csrTime << " ms\n"; 
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+        uint32_t parallelCount = 0; 
+        std::vector<uint32_t> parallelComponents; 
+        auto time = TimeMs([&] { parallelComponents = ParallelWeaklyConnectedComponents(csr, reverse, threads, parallelCount); }); 
+
+        std::cout << "  Afforest " << threads << " threads: " << time << " ms, same components: " 
+            << (parallelCount == csrCount && SamePartition(csrComponents, parallelComponents, csrCount)) << "\n"; 
+    }
+}
+
+void BenchmarkWeaklyConnectedComponents(unsigned int scale, unsigned int edgeFactor, unsigned int maxThreads) {
+    auto nodeCount = (NodeId) 1 << scale; 
+
+    BenchmarkWeaklyConnectedComponents("uniform", GenerateRandomEdges(nodeCount, (size_t) nodeCount * edgeFactor / 8), nodeCount, maxThreads, true); 
+    BenchmarkWeaklyConnectedComponents("R-MAT", GenerateRmatEdges(scale, edgeFactor), nodeCount, maxThreads, true); 
+}
+
+// average log2 of how far apart the ends of an edge are, lower means neighbours are closer in memory
+double AverageLogGap(const CsrGraph& graph) {
+    double total = 0; 
+    for (NodeId node = 0; node < graph.NodeCount(); node++) {
+        for (auto child = graph.ChildrenBegin(node); child != graph.ChildrenEnd(node); child++) {
+            total += std::log2(1.0 + std::abs((double) *child - (double) node)); 
+        }
+    }
+
+    return graph.EdgeCount() ? total / graph.EdgeCount() : 0; 
+}
+
+//------------------------------------------------------------------------------------
+// Name: BenchmarkReordering
+// Desc: shuffle the node ids (like a graph loaded in no particular order), then time full BFS and 
+// DFS on the shuffled graph and on each reordering. Can't count cache misses here so the average 
+// log gap of the edges stands in for locality
+//------------------------------------------------------------------------------------
+void BenchmarkReordering(const char* label, const CsrGraph& original, unsigned int repeats) {
+    auto nodeCount = original.NodeCount(); 
+
+    std::vector<NodeId> shuffle(nodeCount); 
+    std::iota(shuffle.begin(), shuffle.end(), 0); 
+    std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(1234)); 
+
+    CsrGraph shuffled; 
+    CsrGraph reverse; 
+    Relabel(shuffled, original, shuffle); 
+    Transpose(reverse, shuffled); 
+
+    auto start = HighestDegreeNode(shuffled); 
+
+    std::cout << "Reordering, " << label << " " << nodeCount << " nodes " << shuffled.EdgeCount() << " edges\n"; 
+
+    auto run = [&] (const char* name, std::function<std::vector<NodeId>()> makeOrder) {
+        std::vector<NodeId> order; 
+        auto orderTime = TimeMs([&] { order = makeOrder(); }); 
+
+        CsrGraph graph; 
+        Relabel(graph, shuffled, order); 
+        auto graphStart = InverseOrder(order)[start]; 
+
+        double bfsTime = 0; 
+        double dfsTime = 0; 
+        uint64_t reached = 0; 
+
+        for (unsigned int r = 0; r < repeats; r++) {
+            bfsTime += TimeMs([&] { 
+                auto tree = TopDownBfs(graph, graphStart); 
+                reached = std::count_if(tree.distances.begin(), tree.distances.end(), [] (uint32_t d) { return d != Unreachable; }); 
+            }); 
+            dfsTime += TimeMs([&] { DepthFirstForest(graph, false); }); 
+        }
+
+        std::cout << "  " << name << ": order " << orderTime << " ms, BFS " << bfsTime / repeats << " ms (" << reached << " reached), DFS " 
+            << dfsTime / repeats << " ms, log gap " << AverageLogGap(graph) << "\n"; 
+    }; 
+
+    run("shuffled      ", [&] { std::vector<NodeId> order(nodeCount); std::iota(order.begin(), order.end(), 0); return order; }); 
+    run("degree        ", [&] { return DegreeOrder(shuffled, reverse); }); 
+    run("BFS           ", [&] { return BfsOrder(shuffled, reverse); }); 
+    run("RCM           ", [&] { return ReverseCuthillMcKee(shuffled, reverse); }); 
+    run("Gorder        ", [&] { return GorderOrder(shuffled, reverse); }); 
+}
+
+void BenchmarkReordering(unsigned int scale, unsigned int edgeFactor, uint32_t roadSide, unsigned int repeats) {
+    CsrGraph rmat; 
+    FromEdgeList(rmat, GenerateRmatEdges(scale, edgeFactor), (NodeId) 1 << scale); 
+    BenchmarkReordering("R-MAT", rmat, repeats); 
+
+    std::vector<double> xs; 
+    std::vector<double> ys; 
+    CsrGraph roads; 
+    FromEdgeList(roads, GenerateRoadEdges(roadSide, roadSide, xs, ys), roadSide * roadSide); 
+    BenchmarkReordering("road network", roads, repeats); 
+}
+
+//------------------------------------------------------------------------------------
+// Name: main 
+// Desc:
+//------------------------------------------------------------------------------------
+int main() {
+
+    uint8_t adjacencyMatrix[6][6] = 
+    {
+        {0, 1, 0, 0, 1, 1}, // 0 A
+        {0, 0, 0, 1, 1, 0}, // 1 B
+        {0, 1, 0, 0, 0, 0}, // 2 C
+        {0, 0, 1, 0, 1, 0}, // 3 D
+        {0, 0, 0, 0, 0, 0}, // 4 E
+        {0, 0, 0, 0, 0, 0}  // 5 F
+    }; 
+
+    std::vector<std::string> values = { "0", "1", "2", "3", "4", "5" };
+
+    Graph graph;
+    FromAdjacencyMatrix(graph, (uint8_t*)adjacencyMatrix, values, 6); 
+
+    BreadthFirstVisit(graph, nullptr, PrintVisitor([&graph] (NodeId node) { return graph.nodes[node].name; })); 
+    std::cout << "\n"; 
+
+    auto result = BreadthFirstSearch(graph, &graph.nodes[2], &graph.nodes[4]);
+    std::cout << result << "\n";
+
+    DepthFirstSearch(graph);
+
+    CsrGraph csr; 
+    FromAdjacencyMatrix(csr, (uint8_t*)adjacencyMatrix, values, 6); 
+
+    CsrGraph packed; 
+    auto bits = PackAdjacencyMatrix((uint8_t*)adjacencyMatrix, 6); 
+    FromBitPackedAdjacencyMatrix(packed, bits.data(), values, 6); 
+    std::cout << "bit packed matches: " << (packed.targets == csr.targets) << "\n"; 
+
+    std::cout << RouteBetweenNodes(csr, 2, 4) << "\n"; 
+
+    for (auto node : DepthFirstSearch(csr)) {
+        std::cout << csr.names[node] << " "; 
+    }
+
+    std::cout << "\n"; 
+
+    BidirectionalRouter router; 
+    router.Build(csr); 
+
+    std::vector<NodeId> path; 
+    if (RouteBetweenNodes(router, 2, 4, &path)) {
+        for (auto node : path) {
+            std::cout << csr.names[node] << " "; 
+        }
+
+        std::cout << "\n"; 
+    }
+
+    // 1, 2 and 3 form a cycle
+    uint32_t componentCount = 0; 
+    auto components = StronglyConnectedComponents(graph, componentCount); 
+
+    Graph condensed; 
+    Condense(condensed, graph, components, componentCount); 
+
+    for (auto& node : condensed.nodes) {
+        std::cout << "{" << node.name << "} "; 
+    }
+
+    std::cout << "\n"; 
+
+    // 0 -> 1 -> 3 -> 2 -> 1 is a cycle so there's a back edge
+    auto forest = DepthFirstForest(csr); 
+    for (NodeId node = 0; node < csr.NodeCount(); node++) {
+        std::cout << csr.names[node] << " [" << forest.discovery[node] << ", " << forest.finish[node] << "] "; 
+    }
+
+    std::cout << "back edges: " << std::count(forest.edgeTypes.begin(), forest.edgeTypes.end(), EdgeType::Back) << "\n"; 
+
+    // find stops as soon as 4 shows up, the print visitor prints everything reachable from 2
+    FindVisitor find(4); 
+    BreadthFirstVisit(csr, 2, find); 
+    BreadthFirstVisit(graph, &graph.nodes[2], PrintVisitor([&graph] (NodeId node) { return graph.nodes[node].name; })); 
+    std::cout << find.found << "\n"; 
+
+    // 0 -> 4 directly costs 10, going through 1 is cheaper
+    graph.nodes[0].weights = {1, 10, 4}; 
+    graph.nodes[1].weights = {5, 2}; 
+    graph.nodes[2].weights = {1}; 
+    graph.nodes[3].weights = {1, 3}; 
+
+    auto paths = Dijkstra(graph, &graph.nodes[0]); 
+    for (auto node : PathTo(paths, 4)) {
+        std::cout << graph.nodes[node].name << " "; 
+    }
+
+    std::cout << "(" << paths.distances[4] << ")\n"; 
+
+    // nodes in reverse Cuthill-McKee order
+    CsrGraph reverse; 
+    Transpose(reverse, csr); 
+
+    Graph reordered; 
+    Relabel(reordered, graph, ReverseCuthillMcKee(csr, reverse)); 
+    for (auto& node : reordered.nodes) {
+        std::cout << node.name << " "; 
+    }
+
+    std::cout << "\n"; 
+
+    // same graph in the keyed form and back to a CsrGraph
+    KeyRemap<NodeKey> remap; 
+    CsrGraph fromKeyed; 
+    ToKeyedGraph(alternateGraph, csr, remap); 
+    FromKeyedGraph(fromKeyed, alternateGraph, remap); 
+    std::cout << BreadthFirstSearch(alternateGraph, (NodeKey) 2, (NodeKey) 4) << " " << RouteBetweenNodes(fromKeyed, remap.Find(2), remap.Find(4)) << "\n"; 
+
+    BenchmarkCsrGraph(1000000, 10000000); 
+    BenchmarkRepeatedRoutes(1000000, 1500000, 20); 
+    BenchmarkDirectionOptimizingBfs(20, 16); 
+    BenchmarkParallelBfs(20, 16, 8); 
+    BenchmarkBidirectionalRoutes(20, 16, 100); 
+    BenchmarkReachabilityIndex(14, 4, 1000000, 1 << 14); 
+    BenchmarkReachabilityIndex(20, 4, 1000000, 1 << 14); 
+    BenchmarkStronglyConnectedComponents(20, 8, 8); 
+    BenchmarkBitPackedAdjacencyMatrix(20000, 0.01, 4); 
+    BenchmarkLoadEdgeList(18, 16, 4); 
+    BenchmarkDynamicGraph(200000, 800000, 5, 200000, 20); 
+    BenchmarkKeyedGraph(200000, 800000, 20); 
+    BenchmarkWeightedGraphs(1000, 4, 20); 
+    BenchmarkVisitors(1000000, 10000000, 3); 
+    BenchmarkDepthFirstForest(20, 16); 
+    BenchmarkWeaklyConnectedComponents(20, 16, 4); 
+    BenchmarkReordering(20, 16, 1000, 3); 
 
     return 0; 
 }
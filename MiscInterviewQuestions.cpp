@@ -3,10 +3,15 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <list>
 #include <vector>
 #include <unordered_map>
 #include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <chrono>
 
 // Print pyramid numbers
 // 1
@@ -137,9 +142,10 @@ void PrintPyramid3(unsigned int width) {
 
 //
 //
+// Takes and returns views so nothing gets copied, the result points into strA 
+// (result.data() - strA.data() is where it starts) so strA has to outlive it
 //
-//
-std::string LongestSubstring(const std::string& strA, const std::string& strB) {
+std::string_view LongestSubstring(std::string_view strA, std::string_view strB) {
     std::unordered_map<char, std::vector<unsigned int>> characterMap; 
 
     for (auto i = 0; i < strB.length(); i++) {
@@ -157,9 +163,11 @@ std::string LongestSubstring(const std::string& strA, const std::string& strB) {
         // std::cout << c << ": "; 
 
         // find c in our hashmap
-        if (characterMap.find(c) != characterMap.end()) {
+        // NOTE: reference the vector, auto indices = characterMap[c] was copying it for every character
+        auto found = characterMap.find(c); 
+        if (found != characterMap.end()) {
             
-            auto indices = characterMap[c]; 
+            auto& indices = found->second; 
             for (auto i : indices) {
                 // debug
                 // std::cout << i << " ";
@@ -184,6 +192,305 @@ std::string LongestSubstring(const std::string& strA, const std::string& strB) {
     return strA.substr(startIndex, longestSubStringLen); 
 }
 
+//------------------------------------------------------------------------------------------------------------
+// Name: SuffixAutomaton
+// Desc: the smallest automaton that accepts every substring of a string, at most 2n states and 3n 
+// transitions. Each state is a set of substrings that all end at the same places, len is the longest 
+// one and link goes to the state with the next shorter suffixes. firstEnd is where the first 
+// occurrence ends so a state can be turned back into a position.
+// Transitions are lists instead of 256 entries per state, megabyte strings would need gigabytes otherwise. 
+// Built one character at a time in O(n), while building they're linked lists in one vector (cheap to 
+// add to) but following those is a cache miss per edge, so once it's built every state's edges are 
+// copied next to each other sorted by character and the lists are thrown away. A lookup is then one 
+// scan of a few neighbouring (character, target) pairs, usually all in the same cache line. 
+// Everything is indexed with int32_t to keep states and edges small, up to 2n states and 3n edges 
+// have to fit so str can be at most MaxLength (~680 MB)
+//------------------------------------------------------------------------------------------------------------
+struct SuffixAutomaton {
+    static constexpr size_t MaxLength = 0x7fffffff / 3; 
+
+    struct State {
+        int32_t len; 
+        int32_t link; 
+        int32_t firstEnd; 
+        int32_t firstEdge; 
+        int32_t edgeCount; 
+    }; 
+
+    struct Edge {
+        int32_t next; 
+        int32_t to; 
+        unsigned char c; 
+    }; 
+
+    // most states only have 1 or 2 transitions and walking the list is quicker than anything else, 
+    // the few with lots (near the root, with a big alphabet) also get put in an open addressing 
+    // table of (state, c) -> edge
+    static const int32_t HashedEdgeCount = 8; 
+
+    struct Slot {
+        uint64_t key; 
+        int32_t edge; 
+    }; 
+
+    std::vector<State> states; 
+    std::vector<Edge> edges;  // only while building
+    std::vector<Slot> slots;  // only while building
+    size_t hashedEdges = 0; 
+
+    struct Transition {
+        int32_t to; 
+        unsigned char c; 
+    }; 
+
+    // after building state s's edges are [firstEdge, firstEdge + edgeCount) of these, sorted by character
+    std::vector<Transition> transitions; 
+
+    explicit SuffixAutomaton(std::string_view str) : slots(1024, Slot{0, -1}) {
+        states.reserve(2 * str.length() + 1); 
+        edges.reserve(2 * str.length()); 
+
+        states.push_back(State{0, -1, -1, -1, 0}); 
+        int32_t last = 0; 
+
+        for (int32_t i = 0; i < (int32_t) str.length(); i++) {
+            auto c = (unsigned char) str[i]; 
+            auto current = (int32_t) states.size(); 
+            states.push_back(State{states[last].len + 1, 0, i, -1, 0}); 
+
+            auto p = last; 
+            for (; p != -1 && BuildNext(p, c) == -1; p = states[p].link) { SetNext(p, c, current); }
+
+            if (p != -1) {
+                auto q = BuildNext(p, c); 
+
+                if (states[p].len + 1 == states[q].len) {
+                    states[current].link = q; 
+                } else {
+                    // q has longer strings in it that dont end here, split off a copy for the short ones
+                    auto clone = (int32_t) states.size(); 
+                    states.push_back(State{states[p].len + 1, states[q].link, states[q].firstEnd, -1, 0}); 
+                    for (auto e = states[q].firstEdge; e != -1; e = edges[e].next) { SetNext(clone, edges[e].c, edges[e].to); }
+
+                    for (; p != -1 && BuildNext(p, c) == q; p = states[p].link) { SetNext(p, c, clone); }
+                    states[q].link = clone; 
+                    states[current].link = clone; 
+                }
+            }
+
+            last = current; 
+        }
+
+        Compact(); 
+    }
+
+    // copy each state's list into transitions, insertion sorted since nearly every list is only a couple 
+    // of edges long
+    void Compact() {
+        transitions.resize(edges.size()); 
+        int32_t offset = 0; 
+
+        for (auto& state : states) {
+            auto first = offset; 
+
+            for (auto e = state.firstEdge; e != -1; e = edges[e].next, offset++) {
+                auto k = offset; 
+                for (; k > first && transitions[k - 1].c > edges[e].c; k--) { transitions[k] = transitions[k - 1]; }
+                transitions[k] = Transition{edges[e].to, edges[e].c}; 
+            }
+
+            state.firstEdge = first; 
+        }
+
+        std::vector<Edge>().swap(edges); 
+        std::vector<Slot>().swap(slots); 
+        hashedEdges = 0; 
+    }
+
+    // the transition out of state on c, -1 if there isnt one. Only once it's built
+    int32_t Next(int32_t state, unsigned char c) const {
+        auto first = transitions.data() + states[state].firstEdge; 
+        auto last = first + states[state].edgeCount; 
+
+        if (states[state].edgeCount <= HashedEdgeCount) {
+            for (auto t = first; t != last; t++) {
+                if (t->c == c) { return t->to; }
+            }
+
+            return -1; 
+        }
+
+        auto found = std::lower_bound(first, last, c, [] (const Transition& t, unsigned char c) { return t.c < c; }); 
+        return found != last && found->c == c ? found->to : -1; 
+    }
+
+    // key 0 is an empty slot so everything is off by one
+    static uint64_t Key(int32_t state, unsigned char c) { return ((uint64_t) state << 8 | c) + 1; }
+
+    size_t FindSlot(uint64_t key) const {
+        auto mask = slots.size() - 1; 
+        auto i = (size_t) ((key * 0x9e3779b97f4a7c15ull) >> 32) & mask; 
+        while (slots[i].key != 0 && slots[i].key != key) { i = (i + 1) & mask; }
+        return i; 
+    }
+
+    int32_t FindEdge(int32_t state, unsigned char c) const {
+        if (states[state].edgeCount > HashedEdgeCount) { return slots[FindSlot(Key(state, c))].edge; }
+
+        for (auto e = states[state].firstEdge; e != -1; e = edges[e].next) {
+            if (edges[e].c == c) { return e; }
+        }
+
+        return -1; 
+    }
+
+    int32_t BuildNext(int32_t state, unsigned char c) const {
+        auto e = FindEdge(state, c); 
+        return e == -1 ? -1 : edges[e].to; 
+    }
+
+    void SetNext(int32_t state, unsigned char c, int32_t to) {
+        auto e = FindEdge(state, c); 
+        if (e != -1) { edges[e].to = to; return; }
+
+        edges.push_back(Edge{states[state].firstEdge, to, c}); 
+        e = states[state].firstEdge = (int32_t) edges.size() - 1; 
+        auto count = ++states[state].edgeCount; 
+
+        if (count == HashedEdgeCount + 1) {
+            for (auto k = e; k != -1; k = edges[k].next) { Hash(state, k); }
+        } else if (count > HashedEdgeCount + 1) {
+            Hash(state, e); 
+        }
+    }
+
+    void Hash(int32_t state, int32_t edge) {
+        if ((hashedEdges + 1) * 2 > slots.size()) {
+            std::vector<Slot> old(slots.size() * 2, Slot{0, -1}); 
+            old.swap(slots); 
+
+            for (auto& slot : old) {
+                if (slot.key != 0) { slots[FindSlot(slot.key)] = slot; }
+            }
+        }
+
+        auto key = Key(state, edges[edge].c); 
+        slots[FindSlot(key)] = Slot{key, edge}; 
+        hashedEdges++; 
+    }
+}; 
+
+// Longest common substring with a suffix automaton of strA, O(n + m). 
+// Walk strB through it keeping the longest match that ends at the current character, when the 
+// next character doesnt continue it follow the links to shorter suffixes until one does. 
+// Returns a view into strA like LongestSubstring, if there's more than one longest it can 
+// pick a different one. Building the automaton takes 60-80 bytes per character of strA so pass the 
+// shorter string first. 
+// strA longer than SuffixAutomaton::MaxLength would overflow the automaton's indices, that gives an 
+// empty view like when there's nothing in common
+std::string_view LongestSubstring2(std::string_view strA, std::string_view strB) {
+    if (strA.empty() || strB.empty() || strA.length() > SuffixAutomaton::MaxLength) { return strA.substr(0, 0); }
+
+    SuffixAutomaton automaton(strA); 
+
+    int32_t state = 0; 
+    int32_t length = 0; 
+    int32_t bestLength = 0; 
+    int32_t bestEnd = 0; 
+
+    for (auto ch : strB) {
+        auto c = (unsigned char) ch; 
+
+        while (state != 0 && automaton.Next(state, c) == -1) {
+            state = automaton.states[state].link; 
+            length = automaton.states[state].len; 
+        }
+
+        auto next = automaton.Next(state, c); 
+        if (next == -1) {
+            length = 0; 
+            continue; 
+        }
+
+        state = next; 
+        length++; 
+
+        if (length > bestLength) {
+            bestLength = length; 
+            bestEnd = automaton.states[state].firstEnd; 
+        }
+    }
+
+    return strA.substr(bestEnd + 1 - bestLength, bestLength); 
+}
+
+template<typename F> 
+double TimeMs(F f) {
+    auto start = std::chrono::high_resolution_clock::now(); 
+    f(); 
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+}
+
+//------------------------------------------------------------------------------------------------------------
+// Name: BenchmarkLongestSubstring
+// Desc: two random strings with a shared piece planted in both, over 4 and 26 letters, and two 
+// strings that are almost all "ab" repeated which is the worst case for LongestSubstring (half the 
+// position pairs match for hundreds of characters). LongestSubstring only gets the small sizes, 
+// and a tenth of that for "abab..." 
+//------------------------------------------------------------------------------------------------------------
+void BenchmarkLongestSubstring(size_t smallLength, size_t largeLength) {
+    std::mt19937 rng(1234); 
+
+    auto random = [&] (size_t length, unsigned int alphabet) {
+        std::string str(length, 0); 
+        for (auto& c : str) { c = (char) ('a' + rng() % alphabet); }
+        return str; 
+    }; 
+
+    auto run = [&] (const char* label, const std::string& a, const std::string& b, bool runOld) {
+        std::string_view found[2]; 
+        double times[2] = {0, 0}; 
+
+        if (runOld) { times[0] = TimeMs([&] { found[0] = LongestSubstring(a, b); }); }
+        times[1] = TimeMs([&] { found[1] = LongestSubstring2(a, b); }); 
+
+        // the two can pick different substrings when there's a tie, check the lengths and that it's really in b
+        auto ok = b.find(found[1]) != std::string::npos && (!runOld || found[0].length() == found[1].length()); 
+
+        std::cout << "  " << label << " " << a.length() << " x " << b.length() << ": "; 
+        if (runOld) { std::cout << "LongestSubstring " << times[0] << " ms, "; }
+        std::cout << "LongestSubstring2 " << times[1] << " ms, length " << found[1].length() << (ok ? "" : " Error!") << "\n"; 
+    }; 
+
+    auto plant = [&] (std::string& a, std::string& b, size_t length) {
+        auto shared = random(length, 26); 
+        a.replace(rng() % (a.length() - length), length, shared); 
+        b.replace(rng() % (b.length() - length), length, shared); 
+    }; 
+
+    auto repetitive = [&] (size_t length) {
+        std::string str; 
+        while (str.length() < length) { str += "ab"; }
+        for (size_t i = 0; i < length / 1000; i++) { str[rng() % length] = 'c'; }
+        return str; 
+    }; 
+
+    std::cout << "LongestSubstring\n"; 
+
+    for (auto length : {smallLength, largeLength}) {
+        for (auto alphabet : {4u, 26u}) {
+            auto a = random(length, alphabet); 
+            auto b = random(length, alphabet); 
+            plant(a, b, 100); 
+
+            run(alphabet == 4 ? "random, 4 letters " : "random, 26 letters", a, b, length == smallLength); 
+        }
+
+        auto repetitiveLength = length == smallLength ? length / 10 : length; 
+        run("\"abab...\"         ", repetitive(repetitiveLength), repetitive(repetitiveLength), length == smallLength); 
+    }
+}
+
 //------------------------------------------------------------------------------------------------------------
 // Name: main
 //------------------------------------------------------------------------------------------------------------
@@ -207,6 +514,12 @@ int main() {
     std::cout << "abcdefghijkl dfsdfdcvdfdefghsdasr\n"; 
     std::cout << LongestSubstring("abcdefghijkl", "dfsdfdcvdfdefghsdasr") << "\n"; 
 
+    std::cout << "LongestSubstring2\n"; 
+    std::cout << LongestSubstring2("abc", "dbc") << " " << LongestSubstring2("function", "fun") << " " 
+        << LongestSubstring2("abcdefghijkl", "dfsdfdcvdfdefghsdasr") << "\n"; 
+
+    BenchmarkLongestSubstring(20000, 4 * 1024 * 1024); 
+
     return 0; 
 }
 
@@ -8,6 +8,10 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <string>
 #include <math.h>
 #include <cmath>
 
@@ -43,6 +47,53 @@ struct BinaryChildNode {
     }
 };
 
+// BinaryTreeNode
+// BinaryNode generalized to any key type with an optional payload stored inline in the node.
+// Compare works like the one in std::map, nodes are ordered by Compare()(a, b) and two keys are equal
+// if neither is less than the other.
+template<typename Key, typename Value = void, typename Compare = std::less<Key>>
+struct BinaryTreeNode {
+    typedef Key KeyType;
+    typedef Value ValueType;
+    typedef Compare CompareType;
+
+    Key key;
+    Value value;
+
+    BinaryTreeNode* left;
+    BinaryTreeNode* right;
+
+    bool HasChildren() const { return this->left || this->right; }
+
+    ~BinaryTreeNode() {
+        delete left;
+        delete right;
+    }
+};
+
+// no payload, this is the one that replaces BinaryNode so dont store anything except the key and links
+template<typename Key, typename Compare>
+struct BinaryTreeNode<Key, void, Compare> {
+    typedef Key KeyType;
+    typedef void ValueType;
+    typedef Compare CompareType;
+
+    Key key;
+
+    BinaryTreeNode* left;
+    BinaryTreeNode* right;
+
+    bool HasChildren() const { return this->left || this->right; }
+
+    ~BinaryTreeNode() {
+        delete left;
+        delete right;
+    }
+};
+
+// int keys should cost exactly what they did before
+static_assert(sizeof(BinaryTreeNode<int>) == sizeof(BinaryNode), "BinaryTreeNode<int> should be the same size as BinaryNode");
+
 enum TupleId { NODE = 0, LEFT_VISITED = 1, RIGHT_VISITED = 2, DEPTH = 3 };
 
 typedef std::tuple<const BinaryNode*, bool, bool> TraversalFrameState; 
@@ -650,6 +701,643 @@ bool IsValidBST(const BinaryNode& root) {
     // }
 }
 
+//--------------------------------------------------------------------------------------------------------------
+// BinaryTreeNode versions of the algorithms above
+//
+// These are templated on the node so the compiler generates a separate copy for each key type, with int keys and
+// std::less<int> everything inlines down to the same compares as the BinaryNode versions. 
+// The traversals use a plain stack of node pointers instead of the tuple frames because thats less to push per node.
+//--------------------------------------------------------------------------------------------------------------
+
+// true if a and b are the same key according to Compare
+template<typename Key, typename Compare>
+inline bool KeysEqual(const Key& a, const Key& b, const Compare& compare) {
+    return !compare(a, b) && !compare(b, a); 
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: FindInsertLink 
+// Desc: walk down from node to where key should go, returns the null child pointer that the new node should be 
+// written to or nullptr if the key is already in the tree (in which case existing is set)
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare>
+BinaryTreeNode<Key, Value, Compare>** FindInsertLink(const Key& key, BinaryTreeNode<Key, Value, Compare>& node, BinaryTreeNode<Key, Value, Compare>*& existing) {
+    Compare compare; 
+    auto nodePtr = &node;
+
+    while (true) {
+        if (compare(nodePtr->key, key)) {
+            if (nodePtr->right == nullptr) { return &nodePtr->right; }
+            nodePtr = nodePtr->right; 
+        } else if (compare(key, nodePtr->key)) {
+            if (nodePtr->left == nullptr) { return &nodePtr->left; }
+            nodePtr = nodePtr->left; 
+        } else {
+            existing = nodePtr; 
+            return nullptr; 
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BinaryInsert 
+// Desc: insert a key into a tree with no payload, does nothing if the key is already there
+// O(log n) complexity assuming the tree is fairly well balanced
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Compare>
+void BinaryInsert(const Key& key, BinaryTreeNode<Key, void, Compare>& node) {
+    BinaryTreeNode<Key, void, Compare>* existing = nullptr; 
+    auto link = FindInsertLink(key, node, existing); 
+
+    if (link) {
+        *link = new BinaryTreeNode<Key, void, Compare> {key, nullptr, nullptr}; 
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BinaryInsert 
+// Desc: insert a key/value pair, if the key is already there the value is overwritten like std::map::insert_or_assign 
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare>
+void BinaryInsert(const Key& key, const Value& value, BinaryTreeNode<Key, Value, Compare>& node) {
+    BinaryTreeNode<Key, Value, Compare>* existing = nullptr; 
+    auto link = FindInsertLink(key, node, existing); 
+
+    if (link) {
+        *link = new BinaryTreeNode<Key, Value, Compare> {key, value, nullptr, nullptr}; 
+    } else {
+        existing->value = value; 
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BinaryFind
+// Desc: returns the node with key or nullptr
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare>
+const BinaryTreeNode<Key, Value, Compare>* BinaryFind(const Key& key, const BinaryTreeNode<Key, Value, Compare>& root) {
+    Compare compare; 
+    auto nodePtr = &root; 
+
+    while (nodePtr) {
+        if (compare(nodePtr->key, key)) { 
+            nodePtr = nodePtr->right; 
+        } else if (compare(key, nodePtr->key)) { 
+            nodePtr = nodePtr->left; 
+        } else { 
+            return nodePtr; 
+        }
+    }
+
+    return nullptr; 
+}
+
+// default visit function for the traversals, same output as the BinaryNode versions
+struct PrintKey {
+    template<typename Node>
+    void operator()(const Node& node) const { std::cout << node.key << " "; }
+};
+
+//---------------------------------------------------------------------------------------
+// Name: VisitInOrder 
+// Desc: in order non-recursively, visit is called with each node 
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare, typename Visit>
+void VisitInOrder(const BinaryTreeNode<Key, Value, Compare>& rootNode, Visit visit) {
+    std::vector<const BinaryTreeNode<Key, Value, Compare>*> stack; 
+    auto currentNode = &rootNode; 
+
+    while (currentNode || !stack.empty()) {
+        // go as far left as we can then visit on the way back up 
+        while (currentNode) {
+            stack.push_back(currentNode); 
+            currentNode = currentNode->left; 
+        }
+
+        currentNode = stack.back(); 
+        stack.pop_back(); 
+
+        visit(*currentNode); 
+        currentNode = currentNode->right; 
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void VisitInOrder(const BinaryTreeNode<Key, Value, Compare>& rootNode) {
+    VisitInOrder(rootNode, PrintKey()); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------------
+// Name: PreOrderVisit 
+// Desc: 
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare, typename Visit>
+void PreOrderVisit(const BinaryTreeNode<Key, Value, Compare>& rootNode, Visit visit) {
+    std::vector<const BinaryTreeNode<Key, Value, Compare>*> stack; 
+    stack.push_back(&rootNode); 
+
+    while (!stack.empty()) {
+        auto currentNode = stack.back(); 
+        stack.pop_back(); 
+
+        visit(*currentNode); 
+
+        // push right first so left comes off the stack first
+        if (currentNode->right) { stack.push_back(currentNode->right); }
+        if (currentNode->left) { stack.push_back(currentNode->left); }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void PreOrderVisit(const BinaryTreeNode<Key, Value, Compare>& rootNode) {
+    PreOrderVisit(rootNode, PrintKey()); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------------
+// Name: PostOrderVisit 
+// Desc: keep track of the last node we visited, if we just came back up from the right 
+// child (or there isnt one) then its time to visit the node on top of the stack
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare, typename Visit>
+void PostOrderVisit(const BinaryTreeNode<Key, Value, Compare>& rootNode, Visit visit) {
+    std::vector<const BinaryTreeNode<Key, Value, Compare>*> stack; 
+    const BinaryTreeNode<Key, Value, Compare>* lastVisited = nullptr; 
+    auto currentNode = &rootNode; 
+
+    while (currentNode || !stack.empty()) {
+        while (currentNode) {
+            stack.push_back(currentNode); 
+            currentNode = currentNode->left; 
+        }
+
+        auto top = stack.back(); 
+
+        if (top->right && top->right != lastVisited) {
+            currentNode = top->right; 
+        } else {
+            visit(*top); 
+            lastVisited = top; 
+            stack.pop_back(); 
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Compare>
+void PostOrderVisit(const BinaryTreeNode<Key, Value, Compare>& rootNode) {
+    PostOrderVisit(rootNode, PrintKey()); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------
+// Name: Depth
+// Desc: same as the BinaryNode version, the root is at depth 0
+//---------------------------------------------------------------------------------
+template<typename Key, typename Value, typename Compare>
+unsigned int Depth(const BinaryTreeNode<Key, Value, Compare>& parent) {
+    typedef std::tuple<const BinaryTreeNode<Key, Value, Compare>*, unsigned int> Frame; 
+
+    std::vector<Frame> stack; 
+    unsigned int depth = 0; 
+
+    stack.push_back(Frame(&parent, 0)); 
+
+    while (!stack.empty()) {
+        auto currentNode = std::get<0>(stack.back()); 
+        auto currentDepth = std::get<1>(stack.back()); 
+        stack.pop_back(); 
+
+        if (currentDepth > depth) { depth = currentDepth; }
+
+        if (currentNode->left) { stack.push_back(Frame(currentNode->left, currentDepth + 1)); }
+        if (currentNode->right) { stack.push_back(Frame(currentNode->right, currentDepth + 1)); }
+    }
+
+    return depth; 
+}
+
+// 4.3 List Of Depths
+// same as the BinaryNode version, returns the nodes at depth from left to right
+template<typename Key, typename Value, typename Compare>
+std::vector<const BinaryTreeNode<Key, Value, Compare>*> ListOfDepth(const BinaryTreeNode<Key, Value, Compare>& tree, const unsigned int depth) {
+    typedef std::tuple<const BinaryTreeNode<Key, Value, Compare>*, unsigned int> Frame; 
+
+    std::vector<const BinaryTreeNode<Key, Value, Compare>*> nodesAtDepth; 
+    std::vector<Frame> stack; 
+
+    stack.push_back(Frame(&tree, 0)); 
+
+    while (!stack.empty()) {
+        auto currentNode = std::get<0>(stack.back()); 
+        auto currentDepth = std::get<1>(stack.back()); 
+        stack.pop_back(); 
+
+        if (currentDepth == depth) {
+            nodesAtDepth.push_back(currentNode); 
+            continue; 
+        }
+
+        // push right first so we come out left to right
+        if (currentNode->right) { stack.push_back(Frame(currentNode->right, currentDepth + 1)); }
+        if (currentNode->left) { stack.push_back(Frame(currentNode->left, currentDepth + 1)); }
+    }
+
+    return nodesAtDepth; 
+}
+
+// Is a valid binary search tree? 
+// all nodes to the left <= n and all nodes to the right are > 
+// unlike the BinaryNode version this checks against every ancestor not just the parent, each frame carries 
+// the tightest bounds from the path down to it (nullptr means unbounded) 
+template<typename Key, typename Value, typename Compare>
+bool IsValidBST(const BinaryTreeNode<Key, Value, Compare>& root) {
+    typedef std::tuple<const BinaryTreeNode<Key, Value, Compare>*, const Key*, const Key*> Frame; // node, lower (exclusive), upper (inclusive)
+
+    Compare compare; 
+    std::vector<Frame> stack; 
+    stack.push_back(Frame(&root, nullptr, nullptr)); 
+
+    while (!stack.empty()) {
+        auto currentNode = std::get<0>(stack.back()); 
+        auto lower = std::get<1>(stack.back()); 
+        auto upper = std::get<2>(stack.back()); 
+        stack.pop_back(); 
+
+        const Key& key = currentNode->key; 
+
+        // need lower < key <= upper
+        if (lower && !compare(*lower, key)) { return false; }
+        if (upper && compare(*upper, key)) { return false; }
+
+        if (currentNode->left) { stack.push_back(Frame(currentNode->left, lower, &key)); }
+        if (currentNode->right) { stack.push_back(Frame(currentNode->right, &key, upper)); }
+    }
+
+    return true; 
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// CompactBinaryTree
+// Structure of arrays version of BinaryChildNode for really big trees. Instead of each node being its own heap 
+// block with three 64 bit pointers the keys live in one array and the links in another, and the links are 32 bit
+// indices into those arrays. Index 0 is always the root.
+//
+// BinaryChildNode: 32 bytes + malloc overhead (~16 bytes) per node 
+// CompactBinaryTree<int>: 4 bytes key + 12 bytes links per node, nothing else
+//
+// limited to 2^32 - 1 nodes, which is fine for the 100M+ trees this is for
+//--------------------------------------------------------------------------------------------------------------
+typedef uint32_t NodeIndex; 
+const NodeIndex NullIndex = 0xffffffff; 
+
+struct NodeLinks {
+    NodeIndex left; 
+    NodeIndex right; 
+    NodeIndex parent; 
+};
+
+template<typename Key, typename Compare = std::less<Key>>
+struct CompactBinaryTree {
+    std::vector<Key> keys; 
+    std::vector<NodeLinks> links; 
+
+    bool Empty() const { return keys.empty(); }
+    size_t Size() const { return keys.size(); }
+    bool HasChildren(NodeIndex i) const { return links[i].left != NullIndex || links[i].right != NullIndex; }
+
+    // call this if you know roughly how big the tree will get so the arrays dont keep reallocating
+    void Reserve(size_t size) { keys.reserve(size); links.reserve(size); }
+
+    size_t MemoryUsage() const { return keys.capacity() * sizeof(Key) + links.capacity() * sizeof(NodeLinks); }
+};
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BinaryInsert 
+// Desc: returns the index of the new node, or of the existing node if the key is already in the tree 
+// O(log n) complexity assuming the tree is fairly well balanced
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Compare>
+NodeIndex BinaryInsert(const Key& key, CompactBinaryTree<Key, Compare>& tree) {
+    Compare compare; 
+    auto newIndex = (NodeIndex) tree.keys.size(); 
+
+    if (tree.Empty()) {
+        tree.keys.push_back(key); 
+        tree.links.push_back(NodeLinks {NullIndex, NullIndex, NullIndex}); 
+        return newIndex; 
+    }
+
+    NodeIndex current = 0; 
+
+    while (true) {
+        NodeIndex* link = nullptr; 
+
+        if (compare(tree.keys[current], key)) {
+            link = &tree.links[current].right; 
+        } else if (compare(key, tree.keys[current])) {
+            link = &tree.links[current].left; 
+        } else {
+            return current; 
+        }
+
+        if (*link == NullIndex) {
+            // write the link before push_back because push_back can move links
+            *link = newIndex; 
+            tree.keys.push_back(key); 
+            tree.links.push_back(NodeLinks {NullIndex, NullIndex, current}); 
+            return newIndex; 
+        }
+
+        current = *link; 
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BinaryFind
+// Desc: returns the index of key or NullIndex
+//--------------------------------------------------------------------------------------------------------------
+template<typename Key, typename Compare>
+NodeIndex BinaryFind(const Key& key, const CompactBinaryTree<Key, Compare>& tree) {
+    Compare compare; 
+    NodeIndex current = tree.Empty() ? NullIndex : 0; 
+
+    while (current != NullIndex) {
+        if (compare(tree.keys[current], key)) { 
+            current = tree.links[current].right; 
+        } else if (compare(key, tree.keys[current])) { 
+            current = tree.links[current].left; 
+        } else { 
+            return current; 
+        }
+    }
+
+    return NullIndex; 
+}
+
+//---------------------------------------------------------------------------------------
+// Name: VisitInOrder 
+// Desc: same as the BinaryTreeNode version. We could use the parent links and skip the stack but 
+// walking back up touches every node twice which ends up slower on big trees
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Compare, typename Visit>
+void VisitInOrder(const CompactBinaryTree<Key, Compare>& tree, Visit visit) {
+    if (tree.Empty()) { return; }
+
+    std::vector<NodeIndex> stack; 
+    NodeIndex current = 0; 
+
+    while (current != NullIndex || !stack.empty()) {
+        while (current != NullIndex) {
+            stack.push_back(current); 
+            current = tree.links[current].left; 
+        }
+
+        current = stack.back(); 
+        stack.pop_back(); 
+
+        visit(current); 
+        current = tree.links[current].right; 
+    }
+}
+
+template<typename Key, typename Compare>
+void VisitInOrder(const CompactBinaryTree<Key, Compare>& tree) {
+    VisitInOrder(tree, [&tree] (NodeIndex i) { std::cout << tree.keys[i] << " "; }); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------------
+// Name: PreOrderVisit 
+// Desc: 
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Compare, typename Visit>
+void PreOrderVisit(const CompactBinaryTree<Key, Compare>& tree, Visit visit) {
+    if (tree.Empty()) { return; }
+
+    std::vector<NodeIndex> stack; 
+    stack.push_back(0); 
+
+    while (!stack.empty()) {
+        auto current = stack.back(); 
+        stack.pop_back(); 
+
+        visit(current); 
+
+        auto& links = tree.links[current]; 
+        if (links.right != NullIndex) { stack.push_back(links.right); }
+        if (links.left != NullIndex) { stack.push_back(links.left); }
+    }
+}
+
+template<typename Key, typename Compare>
+void PreOrderVisit(const CompactBinaryTree<Key, Compare>& tree) {
+    PreOrderVisit(tree, [&tree] (NodeIndex i) { std::cout << tree.keys[i] << " "; }); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------------
+// Name: PostOrderVisit 
+// Desc: 
+// O(n) complexity, O(depth) memory
+//---------------------------------------------------------------------------------------
+template<typename Key, typename Compare, typename Visit>
+void PostOrderVisit(const CompactBinaryTree<Key, Compare>& tree, Visit visit) {
+    if (tree.Empty()) { return; }
+
+    std::vector<NodeIndex> stack; 
+    NodeIndex lastVisited = NullIndex; 
+    NodeIndex current = 0; 
+
+    while (current != NullIndex || !stack.empty()) {
+        while (current != NullIndex) {
+            stack.push_back(current); 
+            current = tree.links[current].left; 
+        }
+
+        auto top = stack.back(); 
+        auto right = tree.links[top].right; 
+
+        if (right != NullIndex && right != lastVisited) {
+            current = right; 
+        } else {
+            visit(top); 
+            lastVisited = top; 
+            stack.pop_back(); 
+        }
+    }
+}
+
+template<typename Key, typename Compare>
+void PostOrderVisit(const CompactBinaryTree<Key, Compare>& tree) {
+    PostOrderVisit(tree, [&tree] (NodeIndex i) { std::cout << tree.keys[i] << " "; }); 
+    std::cout << "\n"; 
+}
+
+//---------------------------------------------------------------------------------
+// Name: Depth
+// Desc: the root is at depth 0
+//---------------------------------------------------------------------------------
+template<typename Key, typename Compare>
+unsigned int Depth(const CompactBinaryTree<Key, Compare>& tree) {
+    if (tree.Empty()) { return 0; }
+
+    std::vector<std::tuple<NodeIndex, unsigned int>> stack; 
+    unsigned int depth = 0; 
+
+    stack.push_back(std::tuple<NodeIndex, unsigned int>(0, 0)); 
+
+    while (!stack.empty()) {
+        auto current = std::get<0>(stack.back()); 
+        auto currentDepth = std::get<1>(stack.back()); 
+        stack.pop_back(); 
+
+        if (currentDepth > depth) { depth = currentDepth; }
+
+        auto& links = tree.links[current]; 
+        if (links.left != NullIndex) { stack.push_back(std::tuple<NodeIndex, unsigned int>(links.left, currentDepth + 1)); }
+        if (links.right != NullIndex) { stack.push_back(std::tuple<NodeIndex, unsigned int>(links.right, currentDepth + 1)); }
+    }
+
+    return depth; 
+}
+
+// 4.3 List Of Depths
+// returns the indices of the nodes at depth from left to right
+template<typename Key, typename Compare>
+std::vector<NodeIndex> ListOfDepth(const CompactBinaryTree<Key, Compare>& tree, const unsigned int depth) {
+    std::vector<NodeIndex> nodesAtDepth; 
+    if (tree.Empty()) { return nodesAtDepth; }
+
+    std::vector<std::tuple<NodeIndex, unsigned int>> stack; 
+    stack.push_back(std::tuple<NodeIndex, unsigned int>(0, 0)); 
+
+    while (!stack.empty()) {
+        auto current = std::get<0>(stack.back()); 
+        auto currentDepth = std::get<1>(stack.back()); 
+        stack.pop_back(); 
+
+        if (currentDepth == depth) {
+            nodesAtDepth.push_back(current); 
+            continue; 
+        }
+
+        auto& links = tree.links[current]; 
+        if (links.right != NullIndex) { stack.push_back(std::tuple<NodeIndex, unsigned int>(links.right, currentDepth + 1)); }
+        if (links.left != NullIndex) { stack.push_back(std::tuple<NodeIndex, unsigned int>(links.left, currentDepth + 1)); }
+    }
+
+    return nodesAtDepth; 
+}
+
+// Is a valid binary search tree? 
+// all nodes to the left <= n and all nodes to the right are > 
+// same ancestor bounds as the BinaryTreeNode version, just an in order walk that never goes down 
+// would let a key equal to n into the right subtree
+template<typename Key, typename Compare>
+bool IsValidBST(const CompactBinaryTree<Key, Compare>& tree) {
+    typedef std::tuple<NodeIndex, const Key*, const Key*> Frame; // node, lower (exclusive), upper (inclusive)
+
+    if (tree.Empty()) { return true; }
+
+    Compare compare; 
+    std::vector<Frame> stack; 
+    stack.push_back(Frame(0, nullptr, nullptr)); 
+
+    while (!stack.empty()) {
+        auto current = std::get<0>(stack.back()); 
+        auto lower = std::get<1>(stack.back()); 
+        auto upper = std::get<2>(stack.back()); 
+        stack.pop_back(); 
+
+        const Key& key = tree.keys[current]; 
+
+        // need lower < key <= upper
+        if (lower && !compare(*lower, key)) { return false; }
+        if (upper && compare(*upper, key)) { return false; }
+
+        auto& links = tree.links[current]; 
+        if (links.left != NullIndex) { stack.push_back(Frame(links.left, lower, &key)); }
+        if (links.right != NullIndex) { stack.push_back(Frame(links.right, &key, upper)); }
+    }
+
+    return true; 
+}
+
+// 4.8 First Common Ancestor
+// same question as the BinaryChildNode version but with the parent links it's simple, 
+// get both nodes to the same depth then walk them up together until they meet
+template<typename Key, typename Compare>
+NodeIndex FirstCommonAncestor(const CompactBinaryTree<Key, Compare>& tree, NodeIndex nodeA, NodeIndex nodeB) {
+    auto depthOf = [&tree] (NodeIndex i) {
+        unsigned int depth = 0; 
+        while (tree.links[i].parent != NullIndex) { i = tree.links[i].parent; depth++; }
+        return depth; 
+    }; 
+
+    auto depthA = depthOf(nodeA); 
+    auto depthB = depthOf(nodeB); 
+
+    for (; depthA > depthB; depthA--) { nodeA = tree.links[nodeA].parent; }
+    for (; depthB > depthA; depthB--) { nodeB = tree.links[nodeB].parent; }
+
+    while (nodeA != nodeB) {
+        nodeA = tree.links[nodeA].parent; 
+        nodeB = tree.links[nodeB].parent; 
+    }
+
+    return nodeA; 
+}
+
+//--------------------------------------------------------------------------------------------------------------
+// Name: BenchmarkCompactTree
+// Desc: builds the same random tree as a BinaryTreeNode<int> and a CompactBinaryTree<int> and compares memory 
+// and in order traversal time 
+//--------------------------------------------------------------------------------------------------------------
+void BenchmarkCompactTree(unsigned int nodeCount) {
+    std::mt19937 rng(1234); 
+    std::vector<int> keys(nodeCount); 
+    for (auto& k : keys) { k = (int) rng(); }
+
+    auto pointerTree = new BinaryTreeNode<int> {keys[0], nullptr, nullptr}; 
+    CompactBinaryTree<int> compactTree; 
+    compactTree.Reserve(nodeCount); 
+
+    auto start = std::chrono::high_resolution_clock::now(); 
+    for (auto k : keys) { BinaryInsert(k, *pointerTree); }
+    auto pointerBuild = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+
+    start = std::chrono::high_resolution_clock::now(); 
+    for (auto k : keys) { BinaryInsert(k, compactTree); }
+    auto compactBuild = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+
+    int64_t pointerSum = 0; 
+    start = std::chrono::high_resolution_clock::now(); 
+    VisitInOrder(*pointerTree, [&pointerSum] (const BinaryTreeNode<int>& n) { pointerSum += n.key; }); 
+    auto pointerVisit = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+
+    int64_t compactSum = 0; 
+    start = std::chrono::high_resolution_clock::now(); 
+    VisitInOrder(compactTree, [&compactSum, &compactTree] (NodeIndex i) { compactSum += compactTree.keys[i]; }); 
+    auto compactVisit = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count(); 
+
+    // NOTE: pointer tree memory is a guess, 16 bytes is roughly what glibc malloc adds to a small block
+    auto pointerMemory = compactTree.Size() * (sizeof(BinaryTreeNode<int>) + 16); 
+
+    std::cout << "CompactBinaryTree benchmark, " << compactTree.Size() << " nodes, depth " << Depth(compactTree) << "\n"; 
+    std::cout << "  pointer: " << pointerMemory / (1024 * 1024) << " MB, build " << pointerBuild << " ms, in order " << pointerVisit << " ms\n"; 
+    std::cout << "  compact: " << compactTree.MemoryUsage() / (1024 * 1024) << " MB, build " << compactBuild << " ms, in order " << compactVisit << " ms\n"; 
+    std::cout << "  sums match: " << (pointerSum == compactSum) << "\n"; 
+
+    // deleting the pointer tree is recursive in ~BinaryTreeNode but the depth is only ~50 for random keys
+    delete pointerTree; 
+}
+
 // Successor
 // return the leftmost node of the righhand subtree
 BinaryChildNode& Successor(BinaryChildNode& node) {
@@ -1025,25 +1713,26 @@ std::list<std::list<int>> Sequences(const BinaryNode& node) {
     return resultList;     
 }
 
-std::list<std::list<int>> Sequences(const BinaryNode& node) {
-
-    std::list<std::list<int>> result;
-    std::unordered_set<const BinaryNode*, std::list<std::list<int>>> sequences; 
-
-    std::vector<const BinaryNode*> stack; 
-
-    stack.push_back(&node); 
-
-    while(!stack.empty()) {
-
-        // get top of stack node
-
-        // check if sequences contains left 
-
-        // cjhec
-
-    }
-}
+// unfinished iterative version, commented out since it redefines Sequences and stops the file compiling
+// std::list<std::list<int>> Sequences(const BinaryNode& node) {
+//
+//     std::list<std::list<int>> result;
+//     std::unordered_set<const BinaryNode*, std::list<std::list<int>>> sequences; 
+//
+//     std::vector<const BinaryNode*> stack; 
+//
+//     stack.push_back(&node); 
+//
+//     while(!stack.empty()) {
+//
+//         // get top of stack node
+//
+//         // check if sequences contains left 
+//
+//         // cjhec
+//
+//     }
+// }
 
 /*
 
@@ -1388,6 +2077,67 @@ void PrintTree2(BinaryNode& root) {
 // Desc: 
 //--------------------------------------------------------------------------------
 int main() {
+    // the templated node, same keys as node below. These run first since the BinaryNode demos 
+    // further down put stack nodes in trees that delete their children
+    BinaryTreeNode<int> intTree {10, nullptr, nullptr}; 
+
+    BinaryInsert(12, intTree); 
+    BinaryInsert(15, intTree); 
+    BinaryInsert(8, intTree); 
+    BinaryInsert(9, intTree); 
+    BinaryInsert(4, intTree); 
+
+    // 4 8 9 10 12 15
+    VisitInOrder(intTree); 
+
+    // 10 8 4 9 12 15
+    PreOrderVisit(intTree); 
+
+    // 4 9 8 15 12 10
+    PostOrderVisit(intTree); 
+
+    std::cout << "Depth: " << Depth(intTree) << "\n"; 
+    std::cout << "Is valid BST: " << IsValidBST(intTree) << "\n"; 
+
+    // string keys with a payload
+    BinaryTreeNode<std::string, uint64_t> stringTree {"m", 13, nullptr, nullptr}; 
+
+    BinaryInsert(std::string("f"), (uint64_t) 6, stringTree); 
+    BinaryInsert(std::string("t"), (uint64_t) 20, stringTree); 
+    BinaryInsert(std::string("a"), (uint64_t) 1, stringTree); 
+    BinaryInsert(std::string("z"), (uint64_t) 26, stringTree); 
+
+    VisitInOrder(stringTree, [] (const BinaryTreeNode<std::string, uint64_t>& n) { std::cout << n.key << ":" << n.value << " "; }); 
+    std::cout << "\n"; 
+
+    for (auto n : ListOfDepth(stringTree, 1)) {
+        std::cout << n->key << " "; 
+    }
+
+    std::cout << "\n"; 
+
+    auto found = BinaryFind(std::string("t"), stringTree); 
+    if (found) {
+        std::cout << "t -> " << found->value << "\n"; 
+    }
+
+    // compact tree with the same keys as intTree
+    CompactBinaryTree<int> compactTree; 
+    for (auto k : {10, 12, 15, 8, 9, 4}) {
+        BinaryInsert(k, compactTree); 
+    }
+
+    VisitInOrder(compactTree); 
+    PreOrderVisit(compactTree); 
+    PostOrderVisit(compactTree); 
+
+    // common ancestor of 4 and 9 is 8
+    auto ancestor = FirstCommonAncestor(compactTree, BinaryFind(4, compactTree), BinaryFind(9, compactTree)); 
+    std::cout << "First common ancestor of 4 and 9: " << compactTree.keys[ancestor] << "\n"; 
+    std::cout << "Is valid BST: " << IsValidBST(compactTree) << "\n"; 
+
+    BenchmarkCompactTree(1 << 20); 
+
     BinaryNode node {10, nullptr, nullptr}; 
 
     BinaryInsert(12, node); 
@@ -1543,7 +2293,7 @@ int main() {
 
     // BuildOrder(); 
 
-
+    std::cout << "\n";
 
     return 0; 
 }
\ No newline at end of file